@@ -176,4 +176,36 @@ char* Allocator::translate_less_critical(RefTranslation* ref_translation_ptr, re
         return addr;
     }
 }
+
+void Allocator::prefetch(ref_type first, ref_type last) const
+{
+#if REALM_ENABLE_ENCRYPTION
+    auto ref_translation_ptr = m_ref_translation_ptr.load(std::memory_order_acquire);
+    // Only the mapped file is encrypted. Refs below the baseline belong to the
+    // file mappings, which are all covered by the translation table, so this
+    // also keeps the section index within the table.
+    size_t baseline = m_baseline.load(std::memory_order_relaxed);
+    if (!ref_translation_ptr || last < first || first >= baseline)
+        return;
+    size_t idx = get_section_index(first);
+    RefTranslation& txl = ref_translation_ptr[idx];
+    if (!txl.encrypted_mapping)
+        return;
+    size_t offset = first - get_section_base(idx);
+    size_t limit = std::min(baseline - first, (size_t(1) << section_shift) - offset);
+    char* addr = txl.mapping_addr + offset;
+    if (last - first + NodeHeader::header_size <= limit) {
+        // The last array is included by its size, which is read from its
+        // header once that has been decrypted
+        realm::util::encryption_prefetch(addr, last - first, txl.encrypted_mapping,
+                                         NodeHeader::get_byte_size_from_header);
+    }
+    else {
+        realm::util::encryption_prefetch(addr, limit, txl.encrypted_mapping);
+    }
+#else
+    static_cast<void>(first);
+    static_cast<void>(last);
+#endif
+}
 }
@@ -114,6 +114,17 @@ public:
     /// Calls do_translate().
     char* translate(ref_type ref) const noexcept;
 
+    /// Hint that the arrays from the one at \a first up to and including the
+    /// one at \a last are about to be read, e.g. by a scan over a range of the
+    /// file. For encrypted files, this decrypts the pages covering the range
+    /// ahead of time. The range is clipped to the section containing \a
+    /// first. This is not a substitute for translate().
+    void prefetch(ref_type first, ref_type last) const;
+
+    /// Returns true if the file mapped by this allocator is encrypted, in
+    /// which case prefetch() has an effect.
+    bool has_encrypted_mapping() const noexcept;
+
     /// Returns true if, and only if the object at the specified 'ref'
     /// is in the immutable part of the memory managed by this
     /// allocator. The method by which some objects become part of the
@@ -580,6 +591,18 @@ inline char* Allocator::translate(ref_type ref) const noexcept
     }
 }
 
+inline bool Allocator::has_encrypted_mapping() const noexcept
+{
+#if REALM_ENABLE_ENCRYPTION
+    // Either all file mappings are encrypted or none of them are, and the
+    // translation table always has an entry for the first one
+    auto ref_translation_ptr = m_ref_translation_ptr.load(std::memory_order_acquire);
+    return ref_translation_ptr && ref_translation_ptr[0].encrypted_mapping;
+#else
+    return false;
+#endif
+}
+
 
 } // namespace realm
 
@@ -114,11 +114,29 @@ inline SlabAlloc::Slab::Slab(ref_type r, size_t s)
 #endif
 }
 
+SlabAlloc::Slab::Slab(ref_type r, size_t s, const util::File& spill_file, size_t offset)
+    : ref_end(r)
+    , size(s)
+    , spilled(true)
+{
+    addr = static_cast<char*>(spill_file.map(util::File::access_ReadWrite, size, util::File::map_NoSync, offset));
+    total_slab_allocated.fetch_add(s, std::memory_order_relaxed);
+#if REALM_ENABLE_ALLOC_SET_ZERO
+    std::fill(addr, addr + size, 0);
+#endif
+}
+
 SlabAlloc::Slab::~Slab()
 {
     total_slab_allocated.fetch_sub(size, std::memory_order_relaxed);
-    if (addr)
-        util::munmap(addr, size);
+    if (addr) {
+        if (spilled) {
+            util::File::unmap(addr, size);
+        }
+        else {
+            util::munmap(addr, size);
+        }
+    }
 }
 
 void SlabAlloc::detach() noexcept
@@ -152,6 +170,7 @@ void SlabAlloc::detach() noexcept
     // placed correctly (logically) after the end of the file.
     m_slabs.clear();
     clear_freelists();
+    truncate_spill_file();
 #if REALM_ENABLE_ENCRYPTION
     m_realm_file_info = nullptr;
 #endif
@@ -204,6 +223,8 @@ MemRef SlabAlloc::do_alloc(size_t size)
 
     m_free_space_state = free_space_Dirty;
     m_commit_size += size;
+    if (m_commit_size > m_slab_stats.peak_used_size)
+        m_slab_stats.peak_used_size = m_commit_size;
 
     // minimal allocation is sizeof(FreeListEntry)
     if (size < sizeof(FreeBlock))
@@ -213,7 +234,6 @@ MemRef SlabAlloc::do_alloc(size_t size)
         size = (size + 7) & ~0x7;
 
     FreeBlock* entry = allocate_block(static_cast<int>(size));
-    mark_allocated(entry);
     ref_type ref = entry->ref;
 
 #ifdef REALM_DEBUG
@@ -355,25 +375,90 @@ void SlabAlloc::mark_allocated(FreeBlock* entry)
     bb2->block_before_size = 0 - bb2->block_before_size;
 }
 
+void SlabAlloc::push_size_class_entry(FreeBlock* entry, int size)
+{
+    REALM_ASSERT_DEBUG(size <= max_size_class && (size & 0x7) == 0);
+    FreeBlock*& head = m_size_classes[size / 8];
+    entry->prev = nullptr;
+    entry->next = head;
+    head = entry;
+}
+
+void SlabAlloc::merge_size_classes()
+{
+    for (FreeBlock*& head : m_size_classes) {
+        while (FreeBlock* entry = head) {
+            head = entry->next;
+            entry->clear_links();
+            mark_freed(entry, -bb_before(entry)->block_after_size);
+            free_block(entry->ref, entry); // Throws
+        }
+    }
+}
+
+std::vector<ref_type> SlabAlloc::get_size_class_refs() const
+{
+    std::vector<ref_type> refs;
+    for (FreeBlock* head : m_size_classes) {
+        for (FreeBlock* e = head; e; e = e->next)
+            refs.push_back(e->ref);
+    }
+    std::sort(refs.begin(), refs.end());
+    return refs;
+}
+
 SlabAlloc::FreeBlock* SlabAlloc::allocate_block(int size)
 {
-    FreeList list = find(size);
-    if (list.found_exact(size)) {
-        return pop_freelist_entry(list);
+    // A recently freed block of exactly the right size is still marked as
+    // allocated, so it can be handed out directly.
+    if (size <= max_size_class) {
+        FreeBlock*& head = m_size_classes[size / 8];
+        if (FreeBlock* block = head) {
+            head = block->next;
+            block->clear_links();
+            ++m_slab_stats.size_class_allocations;
+            return block;
+        }
     }
-    // no exact matches.
-    list = find_larger(list, size);
+
     FreeBlock* block;
-    if (list.found_something()) {
-        block = pop_freelist_entry(list);
+    if (m_bump_block && size_from_block(m_bump_block) >= size) {
+        block = m_bump_block;
+        m_bump_block = break_block(block, size);
+        ++m_slab_stats.bump_allocations;
     }
     else {
-        block = grow_slab(size);
+        // Neither an exact size block nor the tail is available. Growing
+        // arrays free one size and ask for a larger one, so before searching
+        // the free list, the small blocks freed since are merged into it
+        // where they can be combined with their neighbours.
+        merge_size_classes();
+        FreeList list = find(size);
+        if (list.found_exact(size)) {
+            block = pop_freelist_entry(list);
+        }
+        else {
+            // no exact matches.
+            list = find_larger(list, size);
+            if (list.found_something()) {
+                block = pop_freelist_entry(list);
+                FreeBlock* remaining = break_block(block, size);
+                if (remaining)
+                    push_freelist_entry(remaining);
+            }
+            else {
+                // the tail of the new slab takes over as the bump block
+                block = grow_slab(size);
+                FreeBlock* remaining = break_block(block, size);
+                if (m_bump_block)
+                    push_freelist_entry(m_bump_block);
+                m_bump_block = remaining;
+            }
+        }
+        ++m_slab_stats.free_list_allocations;
     }
-    FreeBlock* remaining = break_block(block, size);
-    if (remaining)
-        push_freelist_entry(remaining);
     REALM_ASSERT_EX(size_from_block(block) >= size, size_from_block(block), size, get_file_path_for_assertions());
+    mark_allocated(block);
     return block;
 }
 
@@ -395,6 +480,8 @@ SlabAlloc::FreeBlock* SlabAlloc::slab_to_entry(const Slab& slab, ref_type ref_st
 void SlabAlloc::clear_freelists()
 {
     m_block_map.clear();
+    std::fill(std::begin(m_size_classes), std::end(m_size_classes), nullptr);
+    m_bump_block = nullptr;
 }
 
 void SlabAlloc::rebuild_freelists_from_slab()
@@ -403,7 +490,12 @@ void SlabAlloc::rebuild_freelists_from_slab()
     ref_type ref_start = align_size_to_section_boundary(m_baseline.load(std::memory_order_relaxed));
     for (const auto& e : m_slabs) {
         FreeBlock* entry = slab_to_entry(e, ref_start);
-        push_freelist_entry(entry);
+        if (&e == &m_slabs.back()) {
+            m_bump_block = entry;
+        }
+        else {
+            push_freelist_entry(entry);
+        }
         ref_start = align_size_to_section_boundary(e.ref_end);
     }
 }
@@ -477,9 +569,27 @@ SlabAlloc::FreeBlock* SlabAlloc::grow_slab(int size)
 
     REALM_ASSERT(matches_section_boundary(ref));
 
+    // Beyond the memory limit, slabs are mapped from the spill file. Slabs
+    // are released in the reverse order of their creation, so the spilled
+    // ones always form a contiguous sequence at the end of the file.
+    bool spill = m_write_memory_limit && !m_cfg.encryption_key &&
+                 already_allocated + new_size > m_write_memory_limit;
+    size_t spill_offset = m_spill_size;
+    if (spill) {
+        if (!m_spill_file.is_attached())
+            open_spill_file(); // Throws
+        m_spill_file.resize(util::File::SizeType(spill_offset + new_size)); // Throws
+    }
+
     std::lock_guard<std::mutex> lock(m_mapping_mutex);
     // Create new slab and add to list of slabs
-    m_slabs.emplace_back(ref_end, new_size); // Throws
+    if (spill) {
+        m_slabs.emplace_back(ref_end, new_size, m_spill_file, spill_offset); // Throws
+        m_spill_size += new_size;
+    }
+    else {
+        m_slabs.emplace_back(ref_end, new_size); // Throws
+    }
     const Slab& slab = m_slabs.back();
     extend_fast_mapping_with_slab(slab.addr);
 
@@ -488,6 +598,75 @@ SlabAlloc::FreeBlock* SlabAlloc::grow_slab(int size)
 }
 
 
+void SlabAlloc::set_write_memory_limit(size_t limit, const std::string& spill_dir)
+{
+    m_write_memory_limit = limit;
+    m_spill_dir = spill_dir;
+    if (!m_spill_dir.empty() && m_spill_dir.back() != '/' && m_spill_dir.back() != '\\')
+        m_spill_dir += '/';
+}
+
+void SlabAlloc::open_spill_file()
+{
+    std::string dir = m_spill_dir;
+    if (dir.empty()) {
+        // No temporary directory is configured (TMPDIR is unset on Android,
+        // for example), so use the directory of the Realm file rather than
+        // the working directory, which need not be writable.
+        std::string file_path = m_file.get_path();
+        auto pos = file_path.find_last_of("/\\");
+        if (pos != std::string::npos)
+            dir = file_path.substr(0, pos + 1);
+    }
+    for (unsigned attempt = 0;; ++attempt) {
+        std::string path = dir + "realm_spill_" + util::to_string(reinterpret_cast<uintptr_t>(this)) + "_" +
+                           util::to_string(attempt);
+        try {
+            m_spill_file.open(path, util::File::access_ReadWrite, util::File::create_Must, 0); // Throws
+        }
+        catch (const util::File::Exists&) {
+            continue;
+        }
+#ifdef _WIN32
+        // An open file cannot be removed, so this is done when it is closed
+        m_spill_path = path;
+#else
+        // Unlink right away so that the space is reclaimed even if the
+        // process is terminated during the transaction
+        util::File::try_remove(path);
+#endif
+        return;
+    }
+}
+
+void SlabAlloc::truncate_spill_file() noexcept
+{
+    if (!m_spill_file.is_attached())
+        return;
+    size_t spill_size = 0;
+    for (const auto& slab : m_slabs) {
+        if (slab.spilled)
+            spill_size += slab.size;
+    }
+    if (spill_size == m_spill_size)
+        return;
+    m_spill_size = spill_size;
+    if (spill_size == 0) {
+        m_spill_file.close();
+        if (!m_spill_path.empty()) {
+            util::File::try_remove(m_spill_path);
+            m_spill_path.clear();
+        }
+        return;
+    }
+    try {
+        m_spill_file.resize(util::File::SizeType(spill_size));
+    }
+    catch (...) {
+        // The file is just left larger than needed
+    }
+}
+
 void SlabAlloc::do_free(ref_type ref, char* addr)
 {
     REALM_ASSERT_EX(translate(ref) == addr, translate(ref), addr, get_file_path_for_assertions());
@@ -565,6 +744,13 @@ void SlabAlloc::do_free(ref_type ref, char* addr)
 
         FreeBlock* e = reinterpret_cast<FreeBlock*>(addr);
         REALM_ASSERT_RELEASE_EX(size < 2UL * 1024 * 1024 * 1024, size, get_file_path_for_assertions());
+        int block_size = -bb_before(e)->block_after_size;
+        if (block_size <= max_size_class) {
+            REALM_ASSERT_DEBUG(block_size >= int(size));
+            e->ref = ref;
+            push_size_class_entry(e, block_size);
+            return;
+        }
         mark_freed(e, static_cast<int>(size));
         free_block(ref, e);
     }
@@ -574,16 +760,32 @@ void SlabAlloc::free_block(ref_type ref, SlabAlloc::FreeBlock* block)
 {
     // merge with surrounding blocks if possible
     block->ref = ref;
+    bool merged_with_bump_block = false;
     FreeBlock* prev = get_prev_block_if_mergeable(block);
     if (prev) {
-        remove_freelist_entry(prev);
+        if (prev == m_bump_block) {
+            merged_with_bump_block = true;
+        }
+        else {
+            remove_freelist_entry(prev);
+        }
         block = merge_blocks(prev, block);
     }
     FreeBlock* next = get_next_block_if_mergeable(block);
     if (next) {
-        remove_freelist_entry(next);
+        if (next == m_bump_block) {
+            merged_with_bump_block = true;
+        }
+        else {
+            remove_freelist_entry(next);
+        }
         block = merge_blocks(block, next);
     }
+    if (merged_with_bump_block) {
+        block->clear_links();
+        m_bump_block = block;
+        return;
+    }
     push_freelist_entry(block);
 }
 
@@ -889,6 +1091,8 @@ ref_type SlabAlloc::attach_file(const std::string& file_path, Config& cfg)
     fcg.release(); // Do not close
 #if REALM_ENABLE_ENCRYPTION
     m_realm_file_info = util::get_file_info_for_file(m_file);
+    if (m_realm_file_info && m_decrypted_page_cache_budget)
+        util::set_decrypted_page_cache_budget(*m_realm_file_info, m_decrypted_page_cache_budget);
 #endif
     return top_ref;
 }
@@ -913,6 +1117,40 @@ void SlabAlloc::note_reader_end(const void* reader_id) noexcept
 #endif
 }
 
+void SlabAlloc::set_decrypted_page_cache_budget(size_t budget_in_bytes)
+{
+    m_decrypted_page_cache_budget = budget_in_bytes;
+#if REALM_ENABLE_ENCRYPTION
+    if (m_realm_file_info)
+        util::set_decrypted_page_cache_budget(*m_realm_file_info, budget_in_bytes);
+#endif
+}
+
+util::decrypted_page_cache_stats_t SlabAlloc::get_decrypted_page_cache_stats() const
+{
+#if REALM_ENABLE_ENCRYPTION
+    if (m_realm_file_info)
+        return util::get_decrypted_page_cache_stats(*m_realm_file_info);
+#endif
+    return {};
+}
+
+std::vector<SlabAlloc::SectionStats> SlabAlloc::get_section_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mapping_mutex);
+    std::vector<SectionStats> stats;
+    stats.reserve(m_mappings.size());
+    for (size_t i = 0; i < m_mappings.size(); ++i) {
+        const auto& mapping = m_mappings[i].primary_mapping;
+        if (!mapping.is_attached())
+            continue;
+        auto mapping_stats = util::get_mapping_stats(mapping.get_addr(), mapping.get_size());
+        stats.push_back({get_section_base(i), mapping.get_size(), mapping_stats.resident_size,
+                         mapping_stats.huge_page_size});
+    }
+    return stats;
+}
+
 ref_type SlabAlloc::attach_buffer(const char* data, size_t size)
 {
     // ExceptionSafety: If this function throws, it must leave the allocator in
@@ -1045,6 +1283,7 @@ void SlabAlloc::reset_free_space_tracking()
         --m_translation_table_size;
         m_slabs.pop_back();
     }
+    truncate_spill_file();
     rebuild_freelists_from_slab();
     m_free_space_state = free_space_Clean;
     m_commit_size = 0;
@@ -1107,6 +1346,17 @@ inline bool randomly_false_in_debug(bool x)
   * The old one is held in a waiting area until it is no longer relevant because no
     live transaction can refer to it any more.
  */
+void SlabAlloc::populate_section_tail(MapEntry& entry, size_t populated_size) noexcept
+{
+    // The section replaces a shorter mapping of the same part of the file. Its
+    // leading pages were populated through that mapping and are still in the
+    // page cache, so only the part which the file has grown by is populated.
+    if (!(m_section_map_flags & File::map_Populate) || m_file.get_encryption_key())
+        return;
+    util::advise_remap(entry.primary_mapping.get_addr(), populated_size, entry.primary_mapping.get_size(),
+                       File::map_Populate);
+}
+
 void SlabAlloc::update_reader_view(size_t file_size)
 {
     std::lock_guard<std::mutex> lock(m_mapping_mutex);
@@ -1140,7 +1390,9 @@ void SlabAlloc::update_reader_view(size_t file_size)
             // extension cannot possibly happen if we alread have a xover mapping established
             REALM_ASSERT(!cur_entry.xover_mapping.is_attached());
             cur_entry.primary_mapping =
-                util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size,
+                                      m_section_map_flags & ~File::map_Populate);
+            populate_section_tail(cur_entry, old_baseline - section_start_offset);
             m_mapping_version++;
         }
         else { // extension stretches over multiple sections:
@@ -1162,7 +1414,9 @@ void SlabAlloc::update_reader_view(size_t file_size)
                 // A xover mapping cannot be present in this case:
                 REALM_ASSERT(!cur_entry.xover_mapping.is_attached());
                 cur_entry.primary_mapping =
-                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size,
+                                          m_section_map_flags & ~File::map_Populate);
+                populate_section_tail(cur_entry, old_baseline - section_start_offset);
                 m_mapping_version++;
             }
 
@@ -1179,7 +1433,8 @@ void SlabAlloc::update_reader_view(size_t file_size)
                 const size_t section_start_offset = get_section_base(k);
                 const size_t section_size = 1 << section_shift;
                 m_mappings[k].primary_mapping =
-                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size,
+                                          m_section_map_flags);
             }
 
             // 3. add a final partial mapping if needed
@@ -1188,7 +1443,8 @@ void SlabAlloc::update_reader_view(size_t file_size)
                 const size_t section_start_offset = get_section_base(num_full_mappings);
                 const size_t section_size = file_size - section_start_offset;
                 m_mappings[num_full_mappings].primary_mapping =
-                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size,
+                                          m_section_map_flags);
             }
         }
     }
@@ -1229,6 +1485,15 @@ size_t SlabAlloc::get_allocated_size() const noexcept
     return sz;
 }
 
+SlabAlloc::SlabStats SlabAlloc::get_slab_stats() const noexcept
+{
+    SlabStats stats = m_slab_stats;
+    stats.slab_size = get_allocated_size();
+    stats.used_size = m_commit_size;
+    stats.spilled_size = m_spill_size;
+    return stats;
+}
+
 void SlabAlloc::extend_fast_mapping_with_slab(char* address)
 {
     ++m_translation_table_size;
@@ -1415,22 +1680,19 @@ void SlabAlloc::verify() const
 
 bool SlabAlloc::is_all_free() const
 {
-    // verify that slabs contain only free space.
-    // this is equivalent to each slab holding BetweenBlocks only at the ends.
-    for (const auto& e : m_slabs) {
-        auto first = reinterpret_cast<BetweenBlocks*>(e.addr);
-        REALM_ASSERT(first->block_before_size == 0);
-        auto last = reinterpret_cast<BetweenBlocks*>(e.addr + e.size) - 1;
-        REALM_ASSERT(last->block_after_size == 0);
-        if (first->block_after_size != last->block_before_size)
-            return false;
-        auto range = reinterpret_cast<char*>(last) - reinterpret_cast<char*>(first);
-        range -= sizeof(BetweenBlocks);
-        // the size of the free area must match the distance between the two BetweenBlocks:
-        if (range != first->block_after_size)
-            return false;
-    }
-    return true;
+    // verify that slabs contain only free space. Blocks in the size class
+    // lists are not merged with their neighbours, so instead of looking for a
+    // single free block per slab, check that the free space reported covers
+    // the entire slab area.
+    if (m_slabs.empty())
+        return true;
+    size_t free_size = 0;
+    for_all_free_entries([&](ref_type, size_t size) {
+        free_size += size;
+    });
+    ref_type begin = align_size_to_section_boundary(m_baseline.load(std::memory_order_relaxed));
+    ref_type end = align_size_to_section_boundary(m_slabs.back().ref_end);
+    return free_size == end - begin;
 }
 
 
@@ -20,6 +20,7 @@
 #define REALM_ALLOC_SLAB_HPP
 
 #include <cstdint> // unint8_t etc
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
@@ -329,11 +330,64 @@ public:
     /// Returns total amount of slab for all slab allocators
     static size_t get_total_slab_size() noexcept;
 
+    struct SlabStats {
+        size_t slab_size = 0;              // Memory currently obtained for slabs
+        size_t used_size = 0;              // Memory currently allocated from the slabs
+        size_t peak_used_size = 0;         // Highest value of used_size seen
+        size_t bump_allocations = 0;       // Blocks cut from the tail of the newest slab
+        size_t size_class_allocations = 0; // Blocks reused from the exact size free lists
+        size_t free_list_allocations = 0;  // Blocks taken from the general free lists
+        size_t spilled_size = 0;           // Part of slab_size backed by the spill file
+    };
+
+    /// Statistics of the slab area. The allocation counters are cumulative
+    /// over the lifetime of the allocator and are meant for diagnostics.
+    SlabStats get_slab_stats() const noexcept;
+
     /// Hooks used to keep the encryption layer informed of the start and stop
     /// of transactions.
     void note_reader_start(const void* reader_id);
     void note_reader_end(const void* reader_id) noexcept;
 
+    /// Limit the memory used for decrypted pages of the attached file. The
+    /// budget is remembered and applied again whenever a file is attached.
+    /// It has no effect on unencrypted files. A budget of 0 means no limit
+    /// other than the global one set by the page reclaim governor.
+    void set_decrypted_page_cache_budget(size_t budget_in_bytes);
+
+    /// Statistics of the decrypted page cache of the attached file. All
+    /// values are zero if the file is not encrypted.
+    util::decrypted_page_cache_stats_t get_decrypted_page_cache_stats() const;
+
+    /// Hints applied to every section of the file as it is mapped, given as
+    /// a combination of the util::File::map_* flags. Sections which are
+    /// already mapped are not affected.
+    void set_section_map_flags(int map_flags) noexcept
+    {
+        m_section_map_flags = map_flags;
+    }
+
+    /// Once the slabs take up more than \a limit bytes, further slabs are
+    /// mapped from a temporary file in \a spill_dir instead of anonymous
+    /// memory, so that the kernel can write dirty pages of a large write
+    /// transaction back to disk rather than keeping them all in RAM. The
+    /// spill file is truncated as the slabs are released at the end of the
+    /// transaction. A limit of 0 disables spilling. Spilling is never done
+    /// for encrypted files, as it would write decrypted data to disk. If \a
+    /// spill_dir is empty, the directory of the attached file is used.
+    void set_write_memory_limit(size_t limit, const std::string& spill_dir);
+
+    struct SectionStats {
+        size_t offset;         // Position of the section in the file
+        size_t size;           // Mapped size of the section
+        size_t resident_size;  // Part of the section which is in memory
+        size_t huge_page_size; // Part of the section backed by huge pages
+    };
+
+    /// Memory statistics for each section of the file which is currently
+    /// mapped.
+    std::vector<SectionStats> get_section_stats();
+
     void verify() const override;
 #ifdef REALM_DEBUG
     void enable_debug(bool enable)
@@ -391,14 +445,17 @@ private:
         ref_type ref_end;
         char* addr;
         size_t size;
+        bool spilled = false; // mapped from the spill file
 
         Slab(ref_type r, size_t s);
+        Slab(ref_type r, size_t s, const util::File& spill_file, size_t offset);
         ~Slab();
 
         Slab(const Slab&) = delete;
         Slab(Slab&& other) noexcept
             : ref_end(other.ref_end)
             , size(other.size)
+            , spilled(other.spilled)
         {
             addr = other.addr;
             other.addr = nullptr;
@@ -433,6 +490,22 @@ private:
     using FreeListMap = std::map<int, FreeBlock*>; // log(N) addressing for larger blocks
     FreeListMap m_block_map;
 
+    // Small blocks freed during a write transaction are not merged with their
+    // neighbours, but kept in singly linked lists of blocks of exactly the same
+    // size, indexed by size / 8. In the slab they remain marked as allocated.
+    // Together with the bump block this means that the typical copy-on-write
+    // pattern of a write transaction never touches m_block_map. When an
+    // allocation can be served neither from its size class nor from the bump
+    // block, the lists are merged into m_block_map, so that blocks of sizes
+    // which are not requested again are not stranded. Everything is discarded
+    // when the free lists are rebuilt at the end of the transaction.
+    static constexpr int max_size_class = 1024;
+    FreeBlock* m_size_classes[max_size_class / 8 + 1] = {};
+    // Free block at the tail of the newest slab from which new blocks are cut.
+    // It is marked free in the slab, but is not a member of any free list.
+    FreeBlock* m_bump_block = nullptr;
+    SlabStats m_slab_stats;
+
     // abstract notion of a freelist - used to hide whether a freelist
     // is residing in the small blocks or the large blocks structures.
     struct FreeList {
@@ -496,12 +569,19 @@ private:
     FreeBlock* pop_freelist_entry(FreeList list);
     void push_freelist_entry(FreeBlock* entry);
     void remove_freelist_entry(FreeBlock* element);
+    void push_size_class_entry(FreeBlock* entry, int size);
+    void merge_size_classes();
+    // sorted refs of all blocks held in the size class lists
+    std::vector<ref_type> get_size_class_refs() const;
     void rebuild_freelists_from_slab();
     void clear_freelists();
 
     // grow the slab area.
     // returns a free block large enough to handle the request.
     FreeBlock* grow_slab(int size);
+    void open_spill_file();
+    // shrink the spill file to the slabs which are still in use
+    void truncate_spill_file() noexcept;
     // create a single free chunk with "BetweenBlocks" at both ends and a
     // single free chunk between them. This free chunk will be of size:
     //   slab_size - 2 * sizeof(BetweenBlocks)
@@ -584,6 +664,9 @@ private:
         size_t lowest_possible_xover_offset = 0;
         util::File::Map<char> xover_mapping;
     };
+    /// Apply map_Populate to the part of a section beyond \a populated_size,
+    /// when the section has been remapped because the file grew.
+    void populate_section_tail(MapEntry&, size_t populated_size) noexcept;
     std::vector<MapEntry> m_mappings;
     size_t m_translation_table_size = 0;
     uint64_t m_mapping_version = 1;
@@ -591,6 +674,13 @@ private:
     std::mutex m_mapping_mutex;
     util::File m_file;
     util::SharedFileInfo* m_realm_file_info = nullptr;
+    size_t m_decrypted_page_cache_budget = 0;
+    int m_section_map_flags = 0;
+    size_t m_write_memory_limit = 0;
+    std::string m_spill_dir;
+    util::File m_spill_file;
+    std::string m_spill_path; // only kept where the file cannot be unlinked while open
+    size_t m_spill_size = 0;
     // vectors where old mappings, are held from deletion to ensure translations are
     // kept open and ref->ptr translations work for other threads..
     std::vector<OldMapping> m_old_mappings;
@@ -761,6 +851,8 @@ inline bool SlabAlloc::matches_section_boundary(size_t pos) const noexcept
 template <typename Func>
 void SlabAlloc::for_all_free_entries(Func f) const
 {
+    // blocks in the size class lists are marked as allocated in the slab
+    std::vector<ref_type> size_class_refs = get_size_class_refs();
     ref_type ref = align_size_to_section_boundary(m_baseline.load(std::memory_order_relaxed));
     for (const auto& e : m_slabs) {
         BetweenBlocks* bb = reinterpret_cast<BetweenBlocks*>(e.addr);
@@ -778,6 +870,8 @@ void SlabAlloc::for_all_free_entries(Func f) const
                 ref += size;
             }
             else {
+                if (std::binary_search(size_class_refs.begin(), size_class_refs.end(), ref))
+                    f(ref, -size);
                 bb = reinterpret_cast<BetweenBlocks*>(reinterpret_cast<char*>(bb) + sizeof(BetweenBlocks) - size);
                 ref -= size;
             }
@@ -703,6 +703,7 @@ void BPlusTreeBase::create()
 {
     REALM_ASSERT(!is_attached());
     m_root = create_leaf_node(); // Throws
+    m_size = 0;
     if (m_parent) {
         ref_type ref = get_ref();
         _impl::DeepArrayRefDestroyGuard destroy_guard{ref, get_alloc()};
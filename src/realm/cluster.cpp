@@ -31,10 +31,12 @@
 #include "realm/array_ref.hpp"
 #include "realm/array_backlink.hpp"
 #include "realm/index_string.hpp"
+#include "realm/index_fulltext.hpp"
 #include "realm/column_type_traits.hpp"
 #include "realm/replication.hpp"
 #include <iostream>
 #include <cmath>
+#include <numeric>
 
 using namespace realm;
 
@@ -2019,6 +2021,9 @@ void ClusterTree::clear(CascadeState& state)
         if (StringIndex* index = m_owner->get_search_index(col_key)) {
             index->clear();
         }
+        if (FullTextIndex* index = m_owner->get_fulltext_index(col_key)) {
+            index->clear();
+        }
     }
 
     if (state.m_group) {
@@ -2141,6 +2146,9 @@ Obj ClusterTree::insert(ObjKey k, const FieldValues& values)
                         REALM_UNREACHABLE();
                 }
             }
+            if (FullTextIndex* index = table->get_fulltext_index(col_key)) {
+                index->insert(k, init_value.is_null() ? StringData() : init_value.get<String>());
+            }
             return false;
         };
         get_owner()->for_each_public_column(insert_in_column);
@@ -2186,6 +2194,37 @@ Obj ClusterTree::get(ObjKey k)
     return Obj(get_table_ref(), state.mem, k, state.index);
 }
 
+void ClusterTree::get(const std::vector<ObjKey>& keys, util::FunctionRef<void(size_t, MemRef, size_t)> func) const
+{
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    Cluster leaf(0, m_alloc, *this);
+    ClusterNode::IteratorState state(leaf);
+    // Range of keys held by the current leaf. The key ranges of the leaves
+    // do not overlap, so a key within the range is in the leaf or nowhere.
+    int64_t first_key = 0;
+    int64_t last_key = -1;
+    for (size_t i : order) {
+        ObjKey k = keys[i];
+        size_t index;
+        if (k.value >= first_key && k.value <= last_key) {
+            index = leaf.lower_bound_key(ObjKey(k.value - leaf.get_offset()));
+        }
+        else {
+            if (!get_leaf(k, state))
+                throw KeyNotFound("No such object");
+            index = state.m_current_index;
+            first_key = leaf.get_real_key(0).value;
+            last_key = leaf.get_real_key(leaf.node_size() - 1).value;
+        }
+        if (index == leaf.node_size() || leaf.get_real_key(index) != k)
+            throw KeyNotFound("No such object");
+        func(i, leaf.get_mem(), index);
+    }
+}
+
 ConstObj ClusterTree::get(size_t ndx) const
 {
     if (ndx >= m_size) {
@@ -2221,9 +2260,47 @@ void ClusterTree::erase(ObjKey k, CascadeState& state)
             if (StringIndex* index = m_owner->get_search_index(col_key)) {
                 index->erase(k);
             }
+            if (FullTextIndex* index = m_owner->get_fulltext_index(col_key)) {
+                index->erase(k);
+            }
+        }
+    }
+
+    do_erase(k, state);
+}
+
+void ClusterTree::erase(const std::vector<ObjKey>& keys, CascadeState& state)
+{
+    REALM_ASSERT_DEBUG(std::is_sorted(keys.begin(), keys.end()));
+
+    std::vector<StringIndex*> indexes;
+    std::vector<FullTextIndex*> fulltext_indexes;
+    size_t num_cols = get_spec().get_public_column_count();
+    for (size_t col_ndx = 0; col_ndx < num_cols; col_ndx++) {
+        auto col_key = m_owner->spec_ndx2colkey(col_ndx);
+        if (StringIndex* index = m_owner->get_search_index(col_key)) {
+            indexes.push_back(index);
+        }
+        if (FullTextIndex* index = m_owner->get_fulltext_index(col_key)) {
+            fulltext_indexes.push_back(index);
         }
     }
 
+    // Erasing from the back only moves the rows which are kept, and lets the
+    // leaves keep their keys in compact form when their last rows are erased
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+        if (!it->is_unresolved()) {
+            for (StringIndex* index : indexes)
+                index->erase(*it);
+            for (FullTextIndex* index : fulltext_indexes)
+                index->erase(*it);
+        }
+        do_erase(*it, state);
+    }
+}
+
+void ClusterTree::do_erase(ObjKey k, CascadeState& state)
+{
     size_t root_size = m_root->erase(k, state);
 
     bump_content_version();
@@ -125,6 +125,8 @@ public:
     Obj insert(ObjKey k, const FieldValues&);
     // Delete object with given key
     void erase(ObjKey k, CascadeState& state);
+    // Delete the objects with the given keys, which must be sorted and unique
+    void erase(const std::vector<ObjKey>& keys, CascadeState& state);
     // Check if an object with given key exists
     bool is_valid(ObjKey k) const;
     // Lookup and return read-only object
@@ -135,6 +137,10 @@ public:
     ConstObj get(size_t ndx) const;
     // Lookup Obj by index
     Obj get(size_t ndx);
+    // Lookup the objects with the given keys, calling func(i, mem, index) for
+    // each keys[i]. The keys are looked up in ascending order, so that the
+    // tree is only descended once for all the keys held by the same leaf.
+    void get(const std::vector<ObjKey>& keys, util::FunctionRef<void(size_t, MemRef, size_t)> func) const;
     // Get logical index of object identified by k
     size_t get_ndx(ObjKey k) const;
     // Find the leaf containing the requested object
@@ -164,6 +170,8 @@ private:
     size_t m_size = 0;
 
     void replace_root(std::unique_ptr<ClusterNode> leaf);
+    // Erase the object from the clusters, but not from the search indexes
+    void do_erase(ObjKey k, CascadeState& state);
 
     std::unique_ptr<ClusterNode> create_root_from_mem(Allocator& alloc, MemRef mem);
     std::unique_ptr<ClusterNode> create_root_from_ref(Allocator& alloc, ref_type ref)
@@ -65,7 +65,12 @@ enum ColumnAttr {
     col_attr_Nullable = 16,
 
     /// Each element is a list of values
-    col_attr_List = 32
+    col_attr_List = 32,
+
+    /// Specifies that the search index slot of this string column holds a
+    /// full-text index rather than a `StringIndex`. Never encoded into the
+    /// column key.
+    col_attr_FullText = 64
 };
 
 class ColumnAttrMask {
@@ -42,9 +42,15 @@
 #include <realm/disable_sync_to_disk.hpp>
 
 #ifndef _WIN32
+#include <signal.h>
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#define REALM_HAVE_FUTEX 1
+#endif
 #else
 #include <windows.h>
 #include <process.h>
@@ -79,7 +85,48 @@ const uint16_t relaxed_sync_threshold = 50;
 //  9      Fair write transactions requires an additional condition variable,
 //         `write_fairness`
 // 10      Introducing SharedInfo::history_schema_version.
-const uint_fast16_t g_shared_info_version = 10;
+// 11      Introducing SharedInfo::num_waiting_interactive_writers.
+// 12      Introducing SharedInfo::commit_sequence, num_change_waiters and
+//         table_change_versions.
+// 13      Introducing commit_time, locked_space and bound_by_pid in the
+//         entries of the ringbuffer.
+// 14      Replacing SharedInfo::num_waiting_interactive_writers by
+//         interactive_writer_pids.
+// 15      Reserving the last entry of SharedInfo::table_change_versions for
+//         the addition and removal of tables.
+const uint_fast16_t g_shared_info_version = 15;
+
+// Tables are tracked by wait_for_change() in this many buckets. A table index
+// maps to the bucket of the same number modulo num_table_change_buckets. One
+// more bucket tracks the addition and removal of tables, which every filtered
+// waiter watches. Waiters are woken through a bitset with one bit per bucket,
+// plus one bit for waiters which are interested in all changes.
+constexpr size_t num_table_change_buckets = 30;
+constexpr size_t schema_change_bucket = num_table_change_buckets;
+constexpr size_t num_change_buckets = num_table_change_buckets + 1;
+constexpr uint32_t schema_change_bit = uint32_t(1) << schema_change_bucket;
+constexpr uint32_t any_change_bit = uint32_t(1) << num_change_buckets;
+
+// Interactive writers waiting for the write lock are registered in this many
+// slots, see SharedInfo::interactive_writer_pids.
+constexpr size_t num_interactive_writer_slots = 32;
+
+#ifdef REALM_HAVE_FUTEX
+// Both the waiter and the waker share the futex through the mapping of the
+// lock file, so the private futex operations cannot be used.
+void futex_wait(std::atomic<uint32_t>& futex, uint32_t expected, uint32_t bitset) noexcept
+{
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Unexpected atomic layout");
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAIT_BITSET, expected, nullptr, nullptr,
+            bitset);
+}
+
+void futex_wake(std::atomic<uint32_t>& futex, uint32_t bitset) noexcept
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAKE_BITSET, std::numeric_limits<int>::max(), nullptr,
+            nullptr, bitset);
+}
+#endif
 
 // The following functions are carefully designed for minimal overhead
 // in case of contention among read transactions. In case of contention,
@@ -198,6 +245,37 @@ void atomic_dec(std::atomic<T>& counter)
     counter.fetch_sub(1, std::memory_order_release);
 }
 
+uint64_t milliseconds_since_epoch()
+{
+    using namespace std::chrono;
+    return uint64_t(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+uint32_t current_process_id()
+{
+#ifdef _WIN32
+    return uint32_t(GetCurrentProcessId());
+#else
+    return uint32_t(getpid());
+#endif
+}
+
+// If in doubt, for instance because we are not allowed to query the process,
+// it is considered to be alive.
+bool process_is_alive(uint32_t pid)
+{
+#ifdef _WIN32
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, DWORD(pid));
+    if (!process)
+        return GetLastError() != ERROR_INVALID_PARAMETER;
+    bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+#else
+    return ::kill(pid_t(pid), 0) == 0 || errno != ESRCH;
+#endif
+}
+
 // nonblocking ringbuffer
 class Ringbuffer {
 public:
@@ -217,12 +295,18 @@ public:
         uint64_t version;
         uint64_t filesize;
         uint64_t current_top;
+        uint64_t commit_time; // milliseconds since the epoch, zero if unknown
         // The count field acts as synchronization point for accesses to the above
         // fields. A succesfull inc implies acquire with regard to memory consistency.
         // Release is triggered by explicitly storing into count whenever a
         // new entry has been initialized.
         mutable std::atomic<uint32_t> count;
         uint32_t next;
+        // Diagnostics only, see DB::get_bound_versions(). The locked space is
+        // updated by every commit, the process id whenever the entry is bound.
+        mutable std::atomic<uint64_t> locked_space;
+        mutable std::atomic<uint32_t> bound_by_pid;
+        uint32_t filler;
     };
 
     Ringbuffer() noexcept
@@ -233,6 +317,9 @@ public:
             data[i].count.store(1, std::memory_order_relaxed);
             data[i].current_top = 0;
             data[i].filesize = 0;
+            data[i].commit_time = 0;
+            data[i].locked_space.store(0, std::memory_order_relaxed);
+            data[i].bound_by_pid.store(0, std::memory_order_relaxed);
             data[i].next = i + 1;
         }
         old_pos = 0;
@@ -267,6 +354,9 @@ public:
             data[i].count.store(1, std::memory_order_relaxed);
             data[i].current_top = 0;
             data[i].filesize = 0;
+            data[i].commit_time = 0;
+            data[i].locked_space.store(0, std::memory_order_relaxed);
+            data[i].bound_by_pid.store(0, std::memory_order_relaxed);
             data[i].next = i + 1;
         }
         data[new_entries - 1].next = old_pos;
@@ -359,13 +449,45 @@ public:
         // dump();
         while (old_pos.load(std::memory_order_relaxed) != put_pos.load(std::memory_order_relaxed)) {
             const ReadCount& r = get(old_pos.load(std::memory_order_relaxed));
-            if (!atomic_one_if_zero(r.count))
+            // entries which have been retired already have a count of one
+            if (r.count.load(std::memory_order_relaxed) != 1 && !atomic_one_if_zero(r.count))
                 break;
             auto next_ndx = get(old_pos.load(std::memory_order_relaxed)).next;
             old_pos.store(next_ndx, std::memory_order_relaxed);
         }
     }
 
+    // Retire the entries between the oldest and the newest one which are not
+    // bound by any transaction. Like the entries released by cleanup(), they
+    // get a count of one, so that they can no longer be bound. Only the
+    // oldest entry can be bound again once released, so retired entries
+    // stay in place until cleanup() reaches them.
+    void retire_unbound() noexcept
+    {
+        uint_fast32_t last = put_pos.load(std::memory_order_relaxed);
+        uint_fast32_t idx = old_pos.load(std::memory_order_relaxed);
+        if (idx == last)
+            return;
+        for (idx = get(idx).next; idx != last; idx = get(idx).next) {
+            const ReadCount& r = get(idx);
+            if (r.count.load(std::memory_order_relaxed) == 0)
+                atomic_one_if_zero(r.count);
+        }
+    }
+
+    // Call 'fn' with the index of each entry which has not been released or
+    // retired, from the oldest one up to, but not including, the newest one.
+    template <class F>
+    void for_each_bound(F fn) const
+    {
+        uint_fast32_t last = put_pos.load(std::memory_order_relaxed);
+        for (uint_fast32_t idx = old_pos.load(std::memory_order_relaxed); idx != last; idx = get(idx).next) {
+            const ReadCount& r = get(idx);
+            if (r.count.load(std::memory_order_relaxed) != 1)
+                fn(idx, r);
+        }
+    }
+
 private:
     // number of entries. Access synchronized through put_pos.
     uint32_t entries;
@@ -516,6 +638,22 @@ struct alignas(8) DB::SharedInfo {
     InterprocessCondVar::SharedPart pick_next_writer;
     std::atomic<uint32_t> next_ticket;
     uint32_t next_served = 0;
+    /// Process ids of the interactive writers waiting for the write lock, or
+    /// zero for a free slot. Background writers yield to them, see
+    /// DB::start_write(WritePriority, ...). A slot left behind by a process
+    /// which died while waiting is cleared by the next background writer to
+    /// find it. Waiters which find no free slot are not registered.
+    std::atomic<uint32_t> interactive_writer_pids[num_interactive_writer_slots];
+
+    /// Incremented after every commit. Waiters in wait_for_change() sleep on
+    /// this counter when futexes are available.
+    std::atomic<uint32_t> commit_sequence;
+    std::atomic<uint32_t> num_change_waiters;
+
+    /// The latest version which modified a table in each bucket, or added or
+    /// removed a table, see num_table_change_buckets. Only updated while
+    /// holding the write lock.
+    std::atomic<uint64_t> table_change_versions[num_change_buckets];
 
     // IMPORTANT: The ringbuffer MUST be the last field in SharedInfo - see above.
     Ringbuffer readers;
@@ -532,12 +670,51 @@ struct alignas(8) DB::SharedInfo {
         r.filesize = file_size;
         r.version = initial_version;
         r.current_top = top_ref;
+        r.commit_time = milliseconds_since_epoch();
+        r.locked_space.store(0, std::memory_order_relaxed);
     }
 
     uint_fast64_t get_current_version_unchecked() const
     {
         return readers.get_last().version;
     }
+
+    // Returns the slot claimed by the calling process, or
+    // num_interactive_writer_slots if there was no free slot.
+    size_t register_interactive_writer() noexcept
+    {
+        uint32_t pid = current_process_id();
+        for (size_t i = 0; i < num_interactive_writer_slots; ++i) {
+            uint32_t expected = 0;
+            if (interactive_writer_pids[i].compare_exchange_strong(expected, pid, std::memory_order_relaxed))
+                return i;
+        }
+        return num_interactive_writer_slots;
+    }
+
+    void unregister_interactive_writer(size_t slot) noexcept
+    {
+        if (slot < num_interactive_writer_slots)
+            interactive_writer_pids[slot].store(0, std::memory_order_relaxed);
+    }
+
+    bool has_interactive_writers() noexcept
+    {
+        bool found = false;
+        for (auto& slot : interactive_writer_pids) {
+            uint32_t pid = slot.load(std::memory_order_relaxed);
+            if (pid == 0)
+                continue;
+            if (process_is_alive(pid)) {
+                found = true;
+            }
+            else {
+                // Leave it alone if it has been reused in the meantime
+                slot.compare_exchange_strong(pid, 0, std::memory_order_relaxed);
+            }
+        }
+        return found;
+    }
 };
 
 
@@ -558,6 +735,12 @@ DB::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht, int hsv
     InterprocessCondVar::init_shared_part(new_commit_available); // Throws
     InterprocessCondVar::init_shared_part(pick_next_writer);     // Throws
     next_ticket = 0;
+    for (auto& pid : interactive_writer_pids)
+        pid = 0;
+    commit_sequence = 0;
+    num_change_waiters = 0;
+    for (auto& v : table_change_versions)
+        v = 0;
 #ifdef REALM_ASYNC_DAEMON
     InterprocessCondVar::init_shared_part(room_to_write);        // Throws
     InterprocessCondVar::init_shared_part(work_to_do);           // Throws
@@ -761,6 +944,9 @@ void DB::do_open(const std::string& path, bool no_create_file, bool is_backend,
     m_lockfile_prefix = m_coordination_dir + "/access_control";
     SlabAlloc& alloc = m_alloc;
     m_alloc.set_read_only(false);
+    m_alloc.set_decrypted_page_cache_budget(options.decrypted_page_cache_budget);
+    m_alloc.set_section_map_flags(options.section_map_flags);
+    m_alloc.set_write_memory_limit(options.write_memory_limit, options.temp_dir);
 
 #if REALM_METRICS
     if (options.enable_metrics) {
@@ -1065,6 +1251,7 @@ void DB::do_open(const std::string& path, bool no_create_file, bool is_backend,
                 case 10:
                 case 11:
                 case 20:
+                case 21:
                     file_format_ok = true;
                     break;
             }
@@ -1414,6 +1601,9 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
         if (m_transaction_count != 0)
             return false;
 
+        // Pooled transactions refer to the file being replaced
+        clear_transaction_pool();
+
         // group::write() will throw if the file already exists.
         // To prevent this, we have to remove the file (should it exist)
         // before calling group::write().
@@ -1492,11 +1682,75 @@ uint_fast64_t DB::get_number_of_versions()
     return info->number_of_versions;
 }
 
+std::vector<DB::BoundVersionInfo> DB::get_bound_versions()
+{
+    std::vector<BoundVersionInfo> result;
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    SharedInfo* r_info = m_reader_map.get_addr();
+    uint_fast32_t num_entries = r_info->readers.get_num_entries();
+    grow_reader_mapping(num_entries - 1); // Throws
+    r_info = m_reader_map.get_addr();
+    uint64_t now = milliseconds_since_epoch();
+    // The entries are visited by index rather than by following the links,
+    // as other processes may be committing meanwhile. Binding an entry
+    // before reading it ensures that it is not reused while doing so.
+    for (uint_fast32_t idx = 0; idx < num_entries; ++idx) {
+        const Ringbuffer::ReadCount& r = r_info->readers.get(idx);
+        if (!atomic_double_inc_if_even(r.count))
+            continue;
+        uint32_t others = r.count.load(std::memory_order_relaxed) - 2;
+        if (others >= 2) {
+            uint64_t commit_time = r.commit_time;
+            auto age = std::chrono::milliseconds(commit_time && commit_time < now ? now - commit_time : 0);
+            result.push_back({r.version, others / 2, r.bound_by_pid.load(std::memory_order_relaxed), age,
+                              size_t(r.locked_space.load(std::memory_order_relaxed))});
+        }
+        atomic_double_dec(r.count);
+    }
+    std::sort(result.begin(), result.end(), [](const BoundVersionInfo& a, const BoundVersionInfo& b) {
+        return a.version < b.version;
+    });
+    return result;
+}
+
+void DB::set_retention_policy(RetentionPolicy policy)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_retention_policy = std::move(policy);
+    m_retention_limits_exceeded = false;
+}
+
+void DB::check_retention_policy() noexcept
+{
+    std::function<void(const std::vector<BoundVersionInfo>&)> callback;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        if (!m_retention_limits_exceeded)
+            return;
+        m_retention_limits_exceeded = false;
+        callback = m_retention_policy.on_exceeded;
+    }
+    if (!callback)
+        return;
+    // The commit has completed, so a failure here cannot be reported through
+    // it, and must not make it look as if it failed
+    try {
+        callback(get_bound_versions()); // Throws
+    }
+    catch (...) {
+    }
+}
+
 size_t DB::get_allocated_size() const
 {
     return m_alloc.get_allocated_size();
 }
 
+std::vector<SlabAlloc::SectionStats> DB::get_section_stats()
+{
+    return m_alloc.get_section_stats();
+}
+
 DB::~DB() noexcept
 {
     close();
@@ -1510,12 +1764,20 @@ void DB::release_all_read_locks() noexcept
 {
     std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
     SharedInfo* r_info = m_reader_map.get_addr();
-    for (auto& read_lock: m_local_locks_held) {
-        --m_transaction_count;
-        const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
-        atomic_double_dec(r.count);
+    const LocalReadCountChunks* chunks = m_local_read_counts.load(std::memory_order_relaxed);
+    if (!chunks)
+        return;
+    for (size_t i = 0; i < chunks->size(); ++i) {
+        for (size_t j = 0; j < local_read_count_chunk_size; ++j) {
+            // Local locks on the same entry share a single count, see grab_read_lock()
+            uint32_t count = (*chunks)[i][j].count.exchange(0, std::memory_order_relaxed);
+            if (count == 0)
+                continue;
+            m_transaction_count -= int(count);
+            const Ringbuffer::ReadCount& r = r_info->readers.get(uint_fast32_t(i * local_read_count_chunk_size + j));
+            atomic_double_dec(r.count);
+        }
     }
-    m_local_locks_held.clear();
 }
 
 // Note: close() and close_internal() may be called from the DB::~DB().
@@ -1545,6 +1807,8 @@ void DB::close_internal(std::unique_lock<InterprocessMutex> lock, bool allow_ope
         if (!lock.owns_lock())
             lock.lock();
 
+        // Pooled transactions are still attached to the allocator
+        clear_transaction_pool();
         if (m_alloc.is_attached())
             m_alloc.detach();
 
@@ -1601,21 +1865,71 @@ bool DB::has_changed(TransactionRef tr)
 }
 
 bool DB::wait_for_change(TransactionRef tr)
+{
+    return do_wait_for_change(tr->m_read_lock.m_version, any_change_bit);
+}
+
+bool DB::wait_for_change(TransactionRef tr, const std::vector<TableKey>& tables)
+{
+    return do_wait_for_change(tr->m_read_lock.m_version, get_table_buckets(*tr, tables));
+}
+
+uint32_t DB::get_table_buckets(const Group& group, const std::vector<TableKey>& tables)
+{
+    uint32_t buckets = schema_change_bit;
+    for (TableKey key : tables)
+        buckets |= uint32_t(1) << (group.key2ndx(key) % num_table_change_buckets);
+    return buckets;
+}
+
+bool DB::has_changed_since(version_type version, uint32_t buckets)
+{
+    SharedInfo* info = m_file_map.get_addr();
+    if (buckets & any_change_bit)
+        return version != get_version_of_latest_snapshot();
+    for (size_t i = 0; i < num_change_buckets; ++i) {
+        if ((buckets & (uint32_t(1) << i)) &&
+            info->table_change_versions[i].load(std::memory_order_acquire) > version)
+            return true;
+    }
+    return false;
+}
+
+bool DB::do_wait_for_change(version_type version, uint32_t buckets)
 {
     SharedInfo* info = m_file_map.get_addr();
+#ifdef REALM_HAVE_FUTEX
+    for (;;) {
+        // The sequence number must be read before the condition is checked,
+        // so that a commit in between makes the futex wait return at once.
+        uint32_t sequence = info->commit_sequence.load(std::memory_order_acquire);
+        if (!m_wait_for_change_enabled || has_changed_since(version, buckets))
+            break;
+        info->num_change_waiters.fetch_add(1);
+        futex_wait(info->commit_sequence, sequence, buckets);
+        info->num_change_waiters.fetch_sub(1);
+    }
+#else
     std::lock_guard<InterprocessMutex> lock(m_controlmutex);
-    while (tr->m_read_lock.m_version == info->latest_version_number && m_wait_for_change_enabled) {
+    while (m_wait_for_change_enabled && !has_changed_since(version, buckets)) {
         m_new_commit_available.wait(m_controlmutex, 0);
     }
-    return tr->m_read_lock.m_version != info->latest_version_number;
+#endif
+    return has_changed_since(version, buckets);
 }
 
-
 void DB::wait_for_change_release()
 {
     std::lock_guard<InterprocessMutex> lock(m_controlmutex);
     m_wait_for_change_enabled = false;
+#ifdef REALM_HAVE_FUTEX
+    // Waiters in other processes wake up as well, but go back to sleep
+    SharedInfo* info = m_file_map.get_addr();
+    info->commit_sequence.fetch_add(1);
+    futex_wake(info->commit_sequence, FUTEX_BITSET_MATCH_ANY);
+#else
     m_new_commit_available.notify_all();
+#endif
 }
 
 
@@ -1635,26 +1949,31 @@ void Transaction::set_transact_stage(DB::TransactStage stage) noexcept
         size_t num_objects = m_total_rows;
         size_t num_available_versions = static_cast<size_t>(db->get_number_of_versions());
         size_t num_decrypted_pages = realm::util::get_num_decrypted_pages();
+        auto cache_stats = db->m_alloc.get_decrypted_page_cache_stats();
+        metrics::PageCacheStats page_cache;
+        page_cache.hits = cache_stats.hits;
+        page_cache.misses = cache_stats.misses;
+        page_cache.evictions = cache_stats.evictions;
 
         if (stage == DB::transact_Reading) {
             if (m_transact_stage == DB::transact_Writing) {
                 m_metrics->end_write_transaction(total_size, free_space, num_objects, num_available_versions,
-                                                 num_decrypted_pages);
+                                                 num_decrypted_pages, page_cache);
             }
             m_metrics->start_read_transaction();
         }
         else if (stage == DB::transact_Writing) {
             if (m_transact_stage == DB::transact_Reading) {
                 m_metrics->end_read_transaction(total_size, free_space, num_objects, num_available_versions,
-                                                num_decrypted_pages);
+                                                num_decrypted_pages, page_cache);
             }
-            m_metrics->start_write_transaction();
+            m_metrics->start_write_transaction(db->m_write_lock_wait_time);
         }
         else if (stage == DB::transact_Ready) {
             m_metrics->end_read_transaction(total_size, free_space, num_objects, num_available_versions,
-                                            num_decrypted_pages);
+                                            num_decrypted_pages, page_cache);
             m_metrics->end_write_transaction(total_size, free_space, num_objects, num_available_versions,
-                                             num_decrypted_pages);
+                                             num_decrypted_pages, page_cache);
         }
     }
 #endif
@@ -1853,90 +2172,157 @@ void DB::upgrade_file_format(bool allow_file_format_upgrade, int target_file_for
 
 void DB::release_read_lock(ReadLockInfo& read_lock) noexcept
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    bool found_match = false;
-    // simple linear search and move-last-over if a match is found.
-    // common case should have only a modest number of transactions in play..
-    for (size_t j = 0; j < m_local_locks_held.size(); ++j) {
-        if (m_local_locks_held[j].m_version == read_lock.m_version) {
-            m_local_locks_held[j] = m_local_locks_held.back();
-            m_local_locks_held.pop_back();
-            found_match = true;
-            break;
+    LocalReadCount* local = find_local_read_count(read_lock.m_reader_idx);
+    if (local) {
+        // Other local transactions still hold the entry, so the count in the
+        // ringbuffer is left alone
+        uint32_t count = local->count.load(std::memory_order_relaxed);
+        while (count > 1) {
+            if (local->count.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {
+                --m_transaction_count;
+                return;
+            }
         }
     }
-    if (!found_match) {
+    // The count may drop to zero, which is only done with m_mutex locked
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (!local || local->count.load(std::memory_order_relaxed) == 0) {
         REALM_ASSERT(!is_attached());
         // it's OK, someone called close() and all locks where released
         return;
     }
     --m_transaction_count;
+    if (local->count.fetch_sub(1, std::memory_order_relaxed) > 1)
+        return; // the entry is still locked on behalf of other local transactions
     SharedInfo* r_info = m_reader_map.get_addr();
     const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
     atomic_double_dec(r.count); // <-- most of the exec time spent here
 }
 
 
+// All read locks which this DB holds on the same ringbuffer entry share a
+// single count in the entry. Only the first of them increments the count, and
+// only the release of the last one decrements it again. When many threads start
+// read transactions on the latest version, this keeps the count, which lives in
+// memory shared with all other processes, out of the common path. An entry
+// cannot be recycled while we hold it, so the version stored in the local count
+// is still the version of the entry.
+//
+// The local count only goes from zero to one, and back to zero, with m_mutex
+// locked. As long as it is non-zero, further locks on the entry are taken and
+// released with a compare-and-swap on the local count alone.
+DB::LocalReadCount* DB::find_local_read_count(uint_fast32_t reader_idx) const noexcept
+{
+    const LocalReadCountChunks* chunks = m_local_read_counts.load(std::memory_order_acquire);
+    size_t chunk_ndx = reader_idx / local_read_count_chunk_size;
+    if (!chunks || chunk_ndx >= chunks->size())
+        return nullptr;
+    return &(*chunks)[chunk_ndx][reader_idx % local_read_count_chunk_size];
+}
+
+
+DB::LocalReadCount& DB::get_local_read_count(uint_fast32_t reader_idx)
+{
+    if (LocalReadCount* local = find_local_read_count(reader_idx))
+        return *local;
+    const LocalReadCountChunks* chunks = m_local_read_counts.load(std::memory_order_relaxed);
+    auto grown = chunks ? std::make_unique<LocalReadCountChunks>(*chunks) : std::make_unique<LocalReadCountChunks>();
+    size_t chunk_ndx = reader_idx / local_read_count_chunk_size;
+    m_local_read_count_directories.reserve(m_local_read_count_directories.size() + 1); // Throws
+    while (grown->size() <= chunk_ndx) {
+        m_local_read_count_chunks.push_back(std::make_unique<LocalReadCount[]>(local_read_count_chunk_size)); // Throws
+        grown->push_back(m_local_read_count_chunks.back().get());                                            // Throws
+    }
+    // Lookups may still be using the previous directory, so it is retained
+    m_local_read_counts.store(grown.get(), std::memory_order_release);
+    m_local_read_count_directories.push_back(std::move(grown));
+    return *find_local_read_count(reader_idx);
+}
+
+
+bool DB::try_share_read_lock(ReadLockInfo& read_lock, uint_fast32_t reader_idx, VersionID version_id)
+{
+    LocalReadCount* local = find_local_read_count(reader_idx);
+    if (!local)
+        return false;
+    uint32_t count = local->count.load(std::memory_order_relaxed);
+    do {
+        if (count == 0)
+            return false;
+    } while (!local->count.compare_exchange_weak(count, count + 1, std::memory_order_acquire));
+    read_lock = local->info;
+    ++m_transaction_count;
+    if (version_id.version != std::numeric_limits<version_type>::max() && read_lock.m_version != version_id.version) {
+        release_read_lock(read_lock);
+        throw BadVersion();
+    }
+    return true;
+}
+
+
 void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     REALM_ASSERT_RELEASE(is_attached());
-    if (version_id.version == std::numeric_limits<version_type>::max()) {
-        for (;;) {
-            SharedInfo* r_info = m_reader_map.get_addr();
-            read_lock.m_reader_idx = r_info->readers.last();
-            if (grow_reader_mapping(read_lock.m_reader_idx)) { // Throws
-                // remapping takes time, so retry with a fresh entry
-                continue;
-            }
-            r_info = m_reader_map.get_addr();
-            const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
-            // if the entry is stale and has been cleared by the cleanup process,
-            // we need to start all over again. This is extremely unlikely, but possible.
-            if (!atomic_double_inc_if_even(r.count)) // <-- most of the exec time spent here!
-                continue;
-            read_lock.m_version = r.version;
-            read_lock.m_top_ref = to_size_t(r.current_top);
-            read_lock.m_file_size = to_size_t(r.filesize);
-            m_local_locks_held.emplace_back(read_lock);
-            ++m_transaction_count;
-            // REALM_ASSERT(m_alloc.matches_section_boundary(read_lock.m_file_size));
-            REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
-            return;
-        }
-    }
+    // Fast path: the entry is already locked on behalf of other local
+    // transactions. The write position of the ringbuffer is part of the
+    // never remapped m_file_map.
+    bool latest = version_id.version == std::numeric_limits<version_type>::max();
+    uint_fast32_t reader_idx = latest ? m_file_map.get_addr()->readers.last() : version_id.index;
+    if (try_share_read_lock(read_lock, reader_idx, version_id)) // Throws
+        return;
 
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    REALM_ASSERT_RELEASE(is_attached());
     for (;;) {
         SharedInfo* r_info = m_reader_map.get_addr();
-        read_lock.m_reader_idx = version_id.index;
+        read_lock.m_reader_idx = latest ? r_info->readers.last() : version_id.index;
         if (grow_reader_mapping(read_lock.m_reader_idx)) { // Throws
             // remapping takes time, so retry with a fresh entry
             continue;
         }
+        LocalReadCount& local = get_local_read_count(read_lock.m_reader_idx); // Throws
+        // With m_mutex locked, a non-zero local count cannot drop to zero
+        if (local.count.load(std::memory_order_relaxed) != 0) {
+            if (!latest && local.info.m_version != version_id.version)
+                throw BadVersion();
+            local.count.fetch_add(1, std::memory_order_relaxed);
+            read_lock = local.info;
+            ++m_transaction_count;
+            return;
+        }
         r_info = m_reader_map.get_addr();
         const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
-
-        // if the entry is stale and has been cleared by the cleanup process,
-        // the requested version is no longer available
-        while (!atomic_double_inc_if_even(r.count)) { // <-- most of the exec time spent here!
-            // we failed to lock the version. This could be because the version
-            // is being cleaned up, but also because the cleanup is probing for access
-            // to it. If it's being probed, the tail ptr of the ringbuffer will point
-            // to it. If so we retry. If the tail ptr points somewhere else, the entry
-            // has been cleaned up.
-            if (&r_info->readers.get_oldest() != &r)
-                throw BadVersion();
+        if (latest) {
+            // if the entry is stale and has been cleared by the cleanup process,
+            // we need to start all over again. This is extremely unlikely, but possible.
+            if (!atomic_double_inc_if_even(r.count)) // <-- most of the exec time spent here!
+                continue;
         }
-        // we managed to lock an entry in the ringbuffer, but it may be so old that
-        // the version doesn't match the specific request. In that case we must release and fail
-        if (r.version != version_id.version) {
-            atomic_double_dec(r.count); // <-- release
-            throw BadVersion();
+        else {
+            // if the entry is stale and has been cleared by the cleanup process,
+            // the requested version is no longer available
+            while (!atomic_double_inc_if_even(r.count)) { // <-- most of the exec time spent here!
+                // we failed to lock the version. This could be because the version
+                // is being cleaned up, but also because the cleanup is probing for access
+                // to it. If it's being probed, the tail ptr of the ringbuffer will point
+                // to it. If so we retry. If the tail ptr points somewhere else, the entry
+                // has been cleaned up.
+                if (&r_info->readers.get_oldest() != &r)
+                    throw BadVersion();
+            }
+            // we managed to lock an entry in the ringbuffer, but it may be so old that
+            // the version doesn't match the specific request. In that case we must release and fail
+            if (r.version != version_id.version) {
+                atomic_double_dec(r.count); // <-- release
+                throw BadVersion();
+            }
         }
+        r.bound_by_pid.store(current_process_id(), std::memory_order_relaxed);
         read_lock.m_version = r.version;
         read_lock.m_top_ref = to_size_t(r.current_top);
         read_lock.m_file_size = to_size_t(r.filesize);
-        m_local_locks_held.emplace_back(read_lock);
+        local.info = read_lock;
+        local.count.store(1, std::memory_order_release);
         ++m_transaction_count;
         // REALM_ASSERT(m_alloc.matches_section_boundary(read_lock.m_file_size));
         REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
@@ -1951,6 +2337,8 @@ bool DB::do_try_begin_write()
     // fairness machinery.
     bool got_the_lock = m_writemutex.try_lock();
     if (got_the_lock) {
+        m_write_lock_wait_time = 0;
+        m_write_lock_timer.reset();
         finish_begin_write();
     }
     return got_the_lock;
@@ -1959,13 +2347,21 @@ bool DB::do_try_begin_write()
 void DB::do_begin_write()
 {
     SharedInfo* info = m_file_map.get_addr();
+    metrics::MetricTimer wait_timer;
 
     // Get write lock - the write lock is held until do_end_write().
     //
     // We use a ticketing scheme to ensure fairness wrt performing write transactions.
     // (But cannot do that on Windows until we have interprocess condition variables there)
+    size_t interactive_writer_slot = info->register_interactive_writer();
     uint32_t my_ticket = info->next_ticket.fetch_add(1, std::memory_order_relaxed);
-    m_writemutex.lock(); // Throws
+    try {
+        m_writemutex.lock(); // Throws
+    }
+    catch (...) {
+        info->unregister_interactive_writer(interactive_writer_slot);
+        throw;
+    }
 
     // allow for comparison even after wrap around of ticket numbering:
     int32_t diff = int32_t(my_ticket - info->next_served);
@@ -2015,7 +2411,90 @@ void DB::do_begin_write()
     // In doing so, we may bypass other waiters, hence the condition for yielding
     // should take this situation into account by comparing with '>' instead of '!='
     info->next_served = my_ticket;
+    info->unregister_interactive_writer(interactive_writer_slot);
+    m_write_lock_wait_time = wait_timer.get_elapsed_nanoseconds();
+    m_write_lock_timer.reset();
+    finish_begin_write();
+}
+
+bool DB::do_begin_write(WritePriority priority, std::chrono::milliseconds timeout)
+{
+    bool unbounded = timeout == std::chrono::milliseconds::max();
+    if (priority == WritePriority::interactive && unbounded) {
+        do_begin_write(); // Throws
+        return true;
+    }
+
+    SharedInfo* info = m_file_map.get_addr();
+    metrics::MetricTimer wait_timer;
+    auto deadline = unbounded ? std::chrono::steady_clock::time_point::max()
+                              : std::chrono::steady_clock::now() + timeout;
+    if (priority == WritePriority::interactive) {
+        size_t interactive_writer_slot = info->register_interactive_writer();
+        bool got_the_lock;
+        try {
+            got_the_lock = lock_write_mutex(deadline); // Throws
+        }
+        catch (...) {
+            info->unregister_interactive_writer(interactive_writer_slot);
+            throw;
+        }
+        info->unregister_interactive_writer(interactive_writer_slot);
+        if (!got_the_lock)
+            return false;
+    }
+    else {
+        if (!lock_write_mutex(deadline)) // Throws
+            return false;
+        yield_to_interactive_writers(deadline);
+    }
+    m_write_lock_wait_time = wait_timer.get_elapsed_nanoseconds();
+    m_write_lock_timer.reset();
     finish_begin_write();
+    return true;
+}
+
+bool DB::lock_write_mutex(std::chrono::steady_clock::time_point deadline)
+{
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        m_writemutex.lock(); // Throws
+        return true;
+    }
+
+    // InterprocessMutex has no timed lock, so poll with exponential backoff
+    std::chrono::milliseconds backoff(1);
+    while (!m_writemutex.try_lock()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            return false;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        millisleep(std::max<unsigned long>(1, std::min(backoff, remaining).count()));
+        if (backoff < std::chrono::milliseconds(16))
+            backoff *= 2;
+    }
+    return true;
+}
+
+void DB::yield_to_interactive_writers(std::chrono::steady_clock::time_point deadline)
+{
+    // Must be called with the write mutex locked. Waiting on m_pick_next_writer
+    // releases it, allowing the interactive writers to go first. We are woken
+    // up when they end their write transactions.
+    SharedInfo* info = m_file_map.get_addr();
+    auto now = std::chrono::steady_clock::now();
+    auto limit = std::min(deadline, now + max_background_write_yield);
+    while (info->has_interactive_writers() && now < limit) {
+        // InterprocessCondVar measures time against the realtime clock
+        auto delay = std::chrono::duration_cast<std::chrono::microseconds>(limit - now);
+        timeval tv;
+        gettimeofday(&tv, nullptr);
+        uint64_t usec = uint64_t(tv.tv_usec) + uint64_t(delay.count());
+        timespec time_limit;
+        time_limit.tv_sec = tv.tv_sec + time_t(usec / 1000000);
+        time_limit.tv_nsec = long(usec % 1000000) * 1000;
+        m_pick_next_writer.wait(m_writemutex, &time_limit);
+        now = std::chrono::steady_clock::now();
+    }
 }
 
 void DB::finish_begin_write()
@@ -2048,6 +2527,10 @@ void DB::finish_begin_write()
 
 void DB::do_end_write() noexcept
 {
+#if REALM_METRICS
+    if (m_metrics)
+        m_metrics->set_write_lock_hold_time(m_write_lock_timer.get_elapsed_nanoseconds());
+#endif
     SharedInfo* info = m_file_map.get_addr();
     info->next_served++;
     m_pick_next_writer.notify_all();
@@ -2119,6 +2602,8 @@ DB::version_type Transaction::commit_and_continue_as_read()
     // Remap file if it has grown, and update refs in underlying node structure
     remap_and_update_refs(m_read_lock.m_top_ref, m_read_lock.m_file_size, false); // Throws
 
+    db->check_retention_policy();
+
     m_history = nullptr;
     set_transact_stage(DB::transact_Reading);
 
@@ -2187,6 +2672,10 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
     // Version of oldest snapshot currently (or recently) bound in a transaction
     // of the current session.
     uint_fast64_t oldest_version;
+    std::vector<GroupWriter::BoundVersion> bound_versions;
+    // Ringbuffer index of each version bound by a reader, and its position
+    // in bound_versions
+    std::vector<std::pair<uint_fast32_t, size_t>> bound_by_readers;
     {
         std::lock_guard<std::recursive_mutex> lock(m_mutex);
         SharedInfo* r_info = m_reader_map.get_addr();
@@ -2201,6 +2690,18 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
         const Ringbuffer::ReadCount& rc = r_info->readers.get_oldest();
         oldest_version = rc.version;
 
+        // Versions between the oldest and the newest one which nobody is
+        // reading are made unavailable, so the space which only they can
+        // reach may be reused. This prevents a single long running reader
+        // from pinning the space of every version committed after it.
+        if (m_reclaim_unbound_versions)
+            r_info->readers.retire_unbound();
+        r_info->readers.for_each_bound([&](uint_fast32_t idx, const Ringbuffer::ReadCount& r) {
+            if (r.count.load(std::memory_order_relaxed) >= 2)
+                bound_by_readers.emplace_back(idx, bound_versions.size());
+            bound_versions.push_back({r.version, ref_type(r.current_top), size_t(r.filesize)});
+        });
+
         // Allow for trimming of the history. Some types of histories do not
         // need store changesets prior to the oldest bound snapshot.
         if (auto hist = transaction.get_history())
@@ -2216,9 +2717,12 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
     transaction.update_num_objects();
 #endif // REALM_METRICS
 
+    uint32_t changed_buckets = get_changed_table_buckets(transaction);
+
     // info->readers.dump();
     GroupWriter out(transaction, Durability(info->durability)); // Throws
     out.set_versions(new_version, oldest_version);
+    out.set_bound_versions(std::move(bound_versions), m_reclaim_unbound_versions);
     ref_type new_top_ref;
     // Recursively write all changed arrays to end of file
     {
@@ -2231,6 +2735,28 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
         std::lock_guard<std::recursive_mutex> lock_guard(m_mutex);
         m_free_space = out.get_free_space_size();
         m_locked_space = out.get_locked_space_size();
+
+        // Publish how much space each bound version is holding on to. What
+        // is attributed to a version nobody is reading is held on to by the
+        // next older version which is being read.
+        SharedInfo* r_info = m_reader_map.get_addr();
+        auto& locked_space_per_version = out.get_locked_space_per_version();
+        for (size_t i = 0; i < bound_by_readers.size(); ++i) {
+            size_t begin = bound_by_readers[i].second;
+            size_t end = locked_space_per_version.size(); // Empty if nothing is locked
+            if (i + 1 < bound_by_readers.size())
+                end = std::min(end, bound_by_readers[i + 1].second);
+            size_t locked_space = 0;
+            for (size_t j = begin; j < end; ++j)
+                locked_space += locked_space_per_version[j];
+            r_info->readers.get(bound_by_readers[i].first).locked_space.store(locked_space, std::memory_order_relaxed);
+        }
+        if (m_retention_policy.on_exceeded) {
+            auto& policy = m_retention_policy;
+            if ((policy.max_bound_versions && bound_by_readers.size() > policy.max_bound_versions) ||
+                (policy.max_locked_space && m_locked_space > policy.max_locked_space))
+                m_retention_limits_exceeded = true;
+        }
         m_used_space = out.get_file_size() - m_free_space;
         // std::cout << "Writing version " << new_version << ", Topptr " << new_top_ref
         //     << " Read lock at version " << oldest_version << std::endl;
@@ -2258,7 +2784,7 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
         // to the database. The flag "commit_in_critical_phase" is used to prevent such updates.
         info->commit_in_critical_phase = 1;
         {
-            SharedInfo* r_info = m_reader_map.get_addr();
+            r_info = m_reader_map.get_addr();
             if (r_info->readers.is_full()) {
                 // buffer expansion
                 uint_fast32_t entries = r_info->readers.get_num_entries();
@@ -2275,6 +2801,9 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
             r.current_top = new_top_ref;
             r.filesize = new_file_size;
             r.version = new_version;
+            r.commit_time = milliseconds_since_epoch();
+            r.locked_space.store(0, std::memory_order_relaxed);
+            r.bound_by_pid.store(0, std::memory_order_relaxed);
             r_info->readers.use_next();
             // REALM_ASSERT(m_alloc.matches_section_boundary(new_file_size));
             REALM_ASSERT(new_top_ref < new_file_size);
@@ -2289,11 +2818,52 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction)
         std::lock_guard<InterprocessMutex> lock(m_controlmutex);
         info->number_of_versions = new_version - oldest_version + 1;
         info->latest_version_number = new_version;
+        for (size_t i = 0; i < num_change_buckets; ++i) {
+            if (changed_buckets & (uint32_t(1) << i))
+                info->table_change_versions[i].store(new_version, std::memory_order_release);
+        }
 
+#ifdef REALM_HAVE_FUTEX
+        info->commit_sequence.fetch_add(1);
+        if (info->num_change_waiters.load() > 0)
+            futex_wake(info->commit_sequence, changed_buckets | any_change_bit);
+#else
         m_new_commit_available.notify_all();
+#endif
     }
 }
 
+uint32_t DB::get_changed_table_buckets(Transaction& transaction)
+{
+    // A table which has been modified was copied on write, so its entry in
+    // the table array differs from the one of the snapshot the transaction
+    // started from. The same holds for tables which were added or removed.
+    Array& tables = transaction.m_tables;
+    Array old_top(m_alloc);
+    Array old_tables(m_alloc);
+    if (ref_type old_top_ref = transaction.m_read_lock.m_top_ref) {
+        old_top.init_from_ref(old_top_ref);
+        old_tables.init_from_ref(old_top.get_as_ref(1));
+    }
+    size_t new_size = tables.is_attached() ? tables.size() : 0;
+    size_t old_size = old_tables.is_attached() ? old_tables.size() : 0;
+    uint32_t buckets = 0;
+    for (size_t i = 0; i < std::max(new_size, old_size); ++i) {
+        int_fast64_t new_value = i < new_size ? tables.get(i) : 0;
+        int_fast64_t old_value = i < old_size ? old_tables.get(i) : 0;
+        if (new_value == old_value)
+            continue;
+        buckets |= uint32_t(1) << (i % num_table_change_buckets);
+        // Removed tables leave a tagged entry behind, which may be reused
+        auto is_table = [](int_fast64_t value) {
+            return value != 0 && (value & 1) == 0;
+        };
+        if (is_table(new_value) != is_table(old_value))
+            buckets |= schema_change_bit;
+    }
+    return buckets;
+}
+
 #ifdef REALM_DEBUG
 void DB::reserve(size_t size)
 {
@@ -2331,13 +2901,23 @@ std::vector<std::pair<std::string, bool>> DB::get_core_files(const std::string&
     return files;
 }
 
-// FIXME: Extend to provide recycling of transaction objects?
 void TransactionDeleter(Transaction* t)
 {
     t->close();
     delete t;
 }
 
+void DB::pooled_transaction_deleter(Transaction* t)
+{
+    if (t->m_transact_stage == DB::transact_Reading || t->m_transact_stage == DB::transact_Frozen) {
+        // Keep the DB alive until the transaction has been handed over
+        DBRef db = t->db;
+        if (db->return_to_pool(t))
+            return;
+    }
+    TransactionDeleter(t);
+}
+
 TransactionRef DB::start_read(VersionID version_id)
 {
     if (!is_attached())
@@ -2351,17 +2931,64 @@ TransactionRef DB::start_read(VersionID version_id)
     return TransactionRef(tr, TransactionDeleter);
 }
 
-TransactionRef DB::start_frozen(VersionID version_id)
+TransactionRef DB::start_read_pooled(VersionID version_id)
+{
+    return start_pooled(version_id, transact_Reading); // Throws
+}
+
+TransactionRef DB::start_pooled(VersionID version_id, TransactStage stage)
 {
     if (!is_attached())
         throw LogicError(LogicError::wrong_transact_state);
+    auto& pool = (stage == transact_Frozen ? m_frozen_transaction_pool : m_transaction_pool);
+    std::unique_ptr<Transaction> tr;
+    {
+        std::lock_guard<std::mutex> lock(m_transaction_pool_mutex);
+        if (!pool.empty()) {
+            tr = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
     ReadLockInfo read_lock;
     grab_read_lock(read_lock, version_id);
     ReadLockGuard g(*this, read_lock);
-    Transaction* tr = new Transaction(shared_from_this(), &m_alloc, read_lock, DB::transact_Frozen);
+    if (tr) {
+        tr->rebind(shared_from_this(), read_lock, stage); // Throws
+    }
+    else {
+        tr.reset(new Transaction(shared_from_this(), &m_alloc, read_lock, stage));
+    }
     tr->set_file_format_version(get_file_format_version());
     g.release();
-    return TransactionRef(tr, TransactionDeleter);
+    return TransactionRef(tr.release(), pooled_transaction_deleter);
+}
+
+bool DB::return_to_pool(Transaction* tr) noexcept
+{
+    // The read lock is released before taking the pool mutex, so that the pool
+    // mutex is never held while waiting for m_mutex.
+    auto& pool = (tr->is_frozen() ? m_frozen_transaction_pool : m_transaction_pool);
+    tr->end_read_for_pool();
+    std::lock_guard<std::mutex> lock(m_transaction_pool_mutex);
+    if (!is_attached() || pool.size() >= max_pooled_transactions)
+        return false;
+    pool.emplace_back(tr);
+    return true;
+}
+
+void DB::clear_transaction_pool() noexcept
+{
+    std::vector<std::unique_ptr<Transaction>> pool, frozen_pool;
+    {
+        std::lock_guard<std::mutex> lock(m_transaction_pool_mutex);
+        pool.swap(m_transaction_pool);
+        frozen_pool.swap(m_frozen_transaction_pool);
+    }
+}
+
+TransactionRef DB::start_frozen(VersionID version_id)
+{
+    return start_pooled(version_id, transact_Frozen); // Throws
 }
 
 Transaction::Transaction(DBRef _db, SlabAlloc* alloc, DB::ReadLockInfo& rli, DB::TransactStage stage)
@@ -2396,6 +3023,46 @@ void Transaction::end_read()
     do_end_read();
 }
 
+void Transaction::end_read_for_pool() noexcept
+{
+    // Unlike do_end_read(), the group stays attached to the snapshot, so that
+    // rebind() can reuse its table accessors. References obtained by the user
+    // who released the transaction are invalidated, so that they do not come
+    // back to life when the accessors are handed to the next user.
+    invalidate_table_refs();
+    db->release_read_lock(m_read_lock);
+    m_alloc.note_reader_end(this);
+    set_transact_stage(DB::transact_Ready);
+    set_schema_change_notification_handler(nullptr);
+    m_history = nullptr;
+    m_history_read.reset();
+    db.reset();
+}
+
+void Transaction::rebind(DBRef _db, DB::ReadLockInfo& rli, DB::TransactStage stage)
+{
+    // Accessors can only be refreshed forwards, so they are discarded when
+    // binding to an older snapshot
+    if (rli.m_version < m_read_lock.m_version)
+        detach();
+    db = std::move(_db);
+    m_read_lock = rli;
+    m_alloc.note_reader_start(this);
+    // Table accessors created while attaching take their frozen state from
+    // the stage
+    set_transact_stage(stage);
+    try {
+        reattach_shared(m_read_lock.m_top_ref, m_read_lock.m_file_size, false); // Throws
+    }
+    catch (...) {
+        detach();
+        m_alloc.note_reader_end(this);
+        set_transact_stage(DB::transact_Ready);
+        db.reset();
+        throw;
+    }
+}
+
 void Transaction::do_end_read() noexcept
 {
     detach();
@@ -2467,7 +3134,11 @@ void Transaction::rollback()
     if (Replication* repl = db->get_replication())
         repl->abort_transact();
 
+    // A commit_and_continue_writing() may have exceeded the retention policy,
+    // and `db` is reset when ending the read
+    auto shared_db = db;
     do_end_read();
+    shared_db->check_retention_policy();
 }
 
 size_t Transaction::get_commit_size() const
@@ -2503,9 +3174,14 @@ DB::version_type Transaction::commit()
 
     db->do_end_write();
 
+    // The callback of the retention policy runs outside of the write lock,
+    // but `db` is reset when ending the read
+    auto shared_db = db;
     do_end_read();
     m_read_lock = lock_after_commit;
 
+    shared_db->check_retention_policy();
+
     return new_version;
 }
 
@@ -2534,6 +3210,9 @@ void Transaction::commit_and_continue_writing()
 
     bool writable = true;
     remap_and_update_refs(m_read_lock.m_top_ref, m_read_lock.m_file_size, writable); // Throws
+
+    // The callback of the retention policy is deferred until the write lock is
+    // released, see DB::RetentionPolicy.
 }
 
 void Transaction::initialize_replication()
@@ -2571,6 +3250,18 @@ TransactionRef DB::start_write(bool nonblocking)
     else {
         do_begin_write();
     }
+    return start_write_locked();
+}
+
+TransactionRef DB::start_write(WritePriority priority, std::chrono::milliseconds timeout)
+{
+    if (!do_begin_write(priority, timeout)) // Throws
+        return TransactionRef();
+    return start_write_locked();
+}
+
+TransactionRef DB::start_write_locked()
+{
     {
         std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
         if (!is_attached()) {
@@ -2678,6 +3369,7 @@ std::unique_ptr<ConstTableView> Transaction::import_copy_of(ConstTableView& tv,
 
 inline DB::DB(const DBOptions& options)
     : m_key(options.encryption_key)
+    , m_reclaim_unbound_versions(options.reclaim_unbound_versions)
     , m_upgrade_callback(std::move(options.upgrade_callback))
 {
 }
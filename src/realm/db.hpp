@@ -19,6 +19,8 @@
 #ifndef REALM_GROUP_SHARED_HPP
 #define REALM_GROUP_SHARED_HPP
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <cstdint>
 #include <limits>
@@ -201,6 +203,16 @@ public:
     /// changed, false if it might have.
     bool wait_for_change(TransactionRef);
 
+    /// Same as wait_for_change(TransactionRef), but only wakes up when one of
+    /// the specified tables is modified, or any table is added or removed.
+    /// Changes are tracked for groups of tables, so a change to another table
+    /// may occasionally cause a spurious wake up. Return true if one of the
+    /// tables may have changed, or the set of tables has changed.
+    ///
+    /// On Linux, waiters sleep on a futex in the lock file, and a commit only
+    /// wakes the waiters interested in the tables it modified.
+    bool wait_for_change(TransactionRef, const std::vector<TableKey>& tables);
+
     /// release any thread waiting in wait_for_change().
     void wait_for_change_release();
 
@@ -221,11 +233,53 @@ public:
 
     /// Transactions are obtained from one of the following 3 methods:
     TransactionRef start_read(VersionID = VersionID());
+    /// Every call returns a frozen transaction of its own, which close() ends
+    /// like any other transaction. When the last reference to a frozen
+    /// transaction is released while it is still frozen, it is kept in a small
+    /// pool instead of being destroyed, and a later call (or
+    /// Transaction::freeze()) binds it to the requested snapshot, reusing the
+    /// table accessors of all tables which still exist. Accessors obtained
+    /// from a released frozen transaction report that they are detached.
     TransactionRef start_frozen(VersionID = VersionID());
     // If nonblocking is true and a write transaction is already active,
     // an invalid TransactionRef is returned.
     TransactionRef start_write(bool nonblocking = false);
 
+    /// Same as start_read(), but the transaction object is recycled. When the
+    /// returned transaction is released while still reading, it is kept in a
+    /// small pool instead of being destroyed. A later call binds it to the
+    /// requested snapshot, reusing the table accessors of all tables which
+    /// still exist, so that they need not be recreated on first access. If
+    /// the requested snapshot is older than the one the transaction was last
+    /// bound to, its accessors are discarded instead. Accessors obtained from
+    /// a pooled transaction report that they are detached once the transaction
+    /// has been released.
+    TransactionRef start_read_pooled(VersionID = VersionID());
+
+    /// Priority class of a write transaction.
+    enum class WritePriority {
+        interactive, ///< The default, used by start_write(bool)
+        background,  ///< For bulk writers, which should not delay interactive ones
+    };
+
+    /// Start a write transaction of the specified priority class. Before it
+    /// takes the write lock, a background writer waits until no interactive
+    /// writers (in this or other processes) are waiting for it. This wait is
+    /// bounded by `max_background_write_yield`, so background writers are
+    /// delayed, but never starved.
+    ///
+    /// If the write lock cannot be obtained within \a timeout, an invalid
+    /// TransactionRef is returned. As the interprocess write mutex has no timed
+    /// lock, writers with a bounded wait poll for it, sleeping between 1 and 16
+    /// milliseconds between attempts. They do not take a ticket in the queue
+    /// which makes unbounded waits fair, so they may overtake queued writers,
+    /// or be overtaken by them any number of times until the timeout expires.
+    /// Background writers never take a ticket, so that they are not queued
+    /// ahead of interactive writers; without a timeout they block on the
+    /// mutex directly.
+    TransactionRef start_write(WritePriority, std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+    static constexpr std::chrono::milliseconds max_background_write_yield{500};
+
 
     // report statistics of last commit done on THIS DB.
     // The free space reported is what can be expected to be freed
@@ -251,9 +305,57 @@ public:
     /// a read transaction will not immediately release any versions.
     uint_fast64_t get_number_of_versions();
 
+    /// A version which read transactions are bound to.
+    struct BoundVersionInfo {
+        version_type version;
+        /// Number of bindings of the version in all processes. Transactions
+        /// of the same DB on the same version share a single binding.
+        size_t num_bindings;
+        /// Process which most recently bound the version, zero if unknown.
+        uint64_t process_id;
+        /// Time since the version was committed.
+        std::chrono::milliseconds age;
+        /// Space released by the commits after this version, up to and
+        /// including the next newer bound version, which cannot be reused
+        /// until this version is released. As of the start of the latest
+        /// commit, so the space released by that commit is not included.
+        size_t locked_space;
+    };
+
+    /// Get the versions which read transactions in any process are bound
+    /// to, oldest first. Meant for finding the readers which keep old
+    /// versions alive.
+    std::vector<BoundVersionInfo> get_bound_versions();
+
+    struct RetentionPolicy {
+        /// Maximum number of versions older than the latest one which read
+        /// transactions may be bound to, 0 for no limit.
+        size_t max_bound_versions = 0;
+        /// Maximum amount of space which is locked by older versions, see
+        /// get_stats(), 0 for no limit.
+        size_t max_locked_space = 0;
+        /// Called when a commit through this DB leaves one of the limits
+        /// exceeded, with the result of get_bound_versions(). The callback
+        /// is made on the committing thread once the write lock has been
+        /// released, i.e. when the write transaction ends after
+        /// commit_and_continue_writing(). Exceptions thrown by the callback
+        /// are ignored, as the commit has already completed.
+        std::function<void(const std::vector<BoundVersionInfo>&)> on_exceeded;
+    };
+
+    /// Set limits on how much older versions kept alive by read transactions
+    /// may hold on to. Exceeding them does not affect the readers, it only
+    /// leads to a call of the callback, which may then decide what to do
+    /// about it.
+    void set_retention_policy(RetentionPolicy policy);
+
     /// Get the size of the currently allocated slab area
     size_t get_allocated_size() const;
 
+    /// Get memory statistics for each mapped section of the Realm file. The
+    /// sections are mapped according to DBOptions::section_map_flags.
+    std::vector<SlabAlloc::SectionStats> get_section_stats();
+
     /// Compact the database file.
     /// - The method will throw if called inside a transaction.
     /// - The method will throw if called in unattached state.
@@ -370,7 +472,7 @@ protected:
 
 private:
     std::recursive_mutex m_mutex;
-    int m_transaction_count = 0;
+    std::atomic<int> m_transaction_count{0};
     SlabAlloc m_alloc;
     Replication* m_replication = nullptr;
     struct SharedInfo;
@@ -388,17 +490,43 @@ private:
     size_t m_locked_space = 0;
     size_t m_used_space = 0;
     uint_fast32_t m_local_max_entry = 0; // highest version observed by this DB
-    std::vector<ReadLockInfo> m_local_locks_held; // tracks all read locks held by this DB
+    // The read locks which this DB holds on a ringbuffer entry, see
+    // grab_read_lock(). The info is only written while the count is zero.
+    struct LocalReadCount {
+        std::atomic<uint32_t> count{0};
+        ReadLockInfo info;
+    };
+    static constexpr size_t local_read_count_chunk_size = 32;
+    using LocalReadCountChunks = std::vector<LocalReadCount*>;
+    // One LocalReadCount per ringbuffer entry, allocated in chunks as the
+    // ringbuffer grows. Replaced chunk directories are kept until the DB is
+    // destroyed, so lookups need not lock m_mutex.
+    std::atomic<const LocalReadCountChunks*> m_local_read_counts{nullptr};
+    std::vector<std::unique_ptr<LocalReadCount[]>> m_local_read_count_chunks;
+    std::vector<std::unique_ptr<LocalReadCountChunks>> m_local_read_count_directories;
+    static constexpr size_t max_pooled_transactions = 16;
+    std::mutex m_transaction_pool_mutex;
+    std::vector<std::unique_ptr<Transaction>> m_transaction_pool; // see start_read_pooled()
+    // Table accessors remember whether they were created by a frozen
+    // transaction, so frozen transactions are pooled separately
+    std::vector<std::unique_ptr<Transaction>> m_frozen_transaction_pool; // see start_frozen()
     util::File m_file;
     util::File::Map<SharedInfo> m_file_map; // Never remapped, provides access to everything but the ringbuffer
     util::File::Map<SharedInfo> m_reader_map; // provides access to ringbuffer, remapped as needed when it grows
-    bool m_wait_for_change_enabled = true; // Initially wait_for_change is enabled
+    std::atomic<bool> m_wait_for_change_enabled{true}; // Initially wait_for_change is enabled
     bool m_write_transaction_open = false;
+    // Time spent waiting for the write lock, and time since it was obtained.
+    // Only meaningful while the write lock is held by this DB.
+    metrics::nanosecond_storage_t m_write_lock_wait_time = 0;
+    metrics::MetricTimer m_write_lock_timer;
     std::string m_lockfile_path;
     std::string m_lockfile_prefix;
     std::string m_db_path;
     std::string m_coordination_dir;
     const char* m_key;
+    bool m_reclaim_unbound_versions;
+    RetentionPolicy m_retention_policy;  // Protected by m_mutex
+    bool m_retention_limits_exceeded = false; // Protected by m_mutex
     int m_file_format_version = 0;
     util::InterprocessMutex m_writemutex;
 #ifdef REALM_ASYNC_DAEMON
@@ -490,11 +618,43 @@ private:
     // release_read_lock for locks already released must be avoided.
     void release_all_read_locks() noexcept;
 
+    // End the read of a transaction which is no longer referenced and hand it
+    // back to the pool matching its stage. Returns false if the pool is full,
+    // in which case the caller must destroy it.
+    bool return_to_pool(Transaction*) noexcept;
+    static void pooled_transaction_deleter(Transaction*);
+    void clear_transaction_pool() noexcept;
+    // Take a transaction of the given stage from its pool and bind it to the
+    // requested snapshot, or create a new one if the pool is empty
+    TransactionRef start_pooled(VersionID, TransactStage);
+
+    // Find the count of read locks held by this DB on the specified ringbuffer
+    // entry. Returns null if it has not been allocated yet.
+    LocalReadCount* find_local_read_count(uint_fast32_t reader_idx) const noexcept;
+    // Same as find_local_read_count(), but allocates the count if needed. Must
+    // be called with m_mutex locked.
+    LocalReadCount& get_local_read_count(uint_fast32_t reader_idx);
+    // Take another reference to a read lock already held by this DB on the
+    // specified entry, without locking m_mutex. Returns false if the DB holds
+    // no read lock on the entry. Throws BadVersion if the entry holds another
+    // version than the one requested.
+    bool try_share_read_lock(ReadLockInfo&, uint_fast32_t reader_idx, VersionID);
+
     /// return true if write transaction can commence, false otherwise.
     bool do_try_begin_write();
     void do_begin_write();
+    /// return false if the write lock could not be obtained within the timeout.
+    bool do_begin_write(WritePriority, std::chrono::milliseconds timeout);
+    bool lock_write_mutex(std::chrono::steady_clock::time_point deadline);
+    void yield_to_interactive_writers(std::chrono::steady_clock::time_point deadline);
+    // Create the transaction once the write lock has been obtained
+    TransactionRef start_write_locked();
     version_type do_commit(Transaction&);
     void do_end_write() noexcept;
+    // Call the callback of the retention policy if a commit exceeded its
+    // limits. Must be called without holding the write lock. Exceptions thrown
+    // by the callback are ignored.
+    void check_retention_policy() noexcept;
 
     // make sure the given index is within the currently mapped area.
     // if not, expand the mapped area. Returns true if the area is expanded.
@@ -502,6 +662,11 @@ private:
 
     // Must be called only by someone that has a lock on the write mutex.
     void low_level_commit(uint_fast64_t new_version, Transaction& transaction);
+    // Buckets of the tables modified by the transaction, see wait_for_change().
+    uint32_t get_changed_table_buckets(Transaction&);
+    static uint32_t get_table_buckets(const Group&, const std::vector<TableKey>& tables);
+    bool has_changed_since(version_type, uint32_t buckets);
+    bool do_wait_for_change(version_type, uint32_t buckets);
 
     void do_async_commits();
 
@@ -629,6 +794,9 @@ private:
     bool internal_advance_read(O* observer, VersionID target_version, _impl::History&, bool);
     void set_transact_stage(DB::TransactStage stage) noexcept;
     void do_end_read() noexcept;
+    // Support for DB::start_read_pooled() and DB::start_frozen()
+    void end_read_for_pool() noexcept;
+    void rebind(DBRef _db, DB::ReadLockInfo& rli, DB::TransactStage stage);
     void commit_and_continue_writing();
     void initialize_replication();
 
@@ -934,6 +1102,7 @@ inline void Transaction::rollback_and_continue_as_read(O* observer)
 
     m_history = nullptr;
     set_transact_stage(DB::transact_Reading);
+    db->check_retention_policy();
 }
 
 template <class O>
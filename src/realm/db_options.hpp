@@ -101,6 +101,37 @@ struct DBOptions {
     /// is exceeded without being consumed, only the most recent entries will be stored.
     size_t metrics_buffer_size;
 
+    /// The maximum amount of memory, in bytes, used for decrypted pages of an
+    /// encrypted Realm file. Once exceeded, the page reclaimer releases pages
+    /// which have not been used recently. The budget applies to the file, and
+    /// is shared by all DB instances of the file in this process. 0 means no
+    /// limit other than the one set by the page reclaim governor.
+    size_t decrypted_page_cache_budget = 0;
+
+    /// Hints for how the sections of the Realm file are mapped into memory,
+    /// given as a combination of the util::File::map_* flags, e.g.
+    /// map_Populate to avoid first touch page faults after opening a large
+    /// file, or map_HugePages to reduce TLB misses. Ignored for encrypted
+    /// files.
+    int section_map_flags = 0;
+
+    /// The amount of anonymous memory, in bytes, used for the data modified
+    /// by a write transaction before further memory is mapped from a
+    /// temporary file in temp_dir, or next to the Realm file if temp_dir is
+    /// empty. This bounds the memory footprint of very large write
+    /// transactions, at the cost of disk I/O if the system runs low on
+    /// memory. Ignored for encrypted files. 0 means no limit.
+    size_t write_memory_limit = 0;
+
+    /// If set, versions between the oldest and the newest one which no
+    /// transaction is bound to are released when committing, so that the
+    /// space only they can reach is reused. This keeps a long running read
+    /// transaction from making the file grow with every commit, but means
+    /// that a version can only be bound with DB::start_read(VersionID) while
+    /// some transaction is bound to it. It affects all users of the file, so
+    /// it should be set for all of them.
+    bool reclaim_unbound_versions = false;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating DBOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
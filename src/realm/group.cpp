@@ -321,7 +321,7 @@ int Group::get_target_file_format_version_for_session(int current_file_format_ve
         return 11;
     }
 
-    return 20;
+    return 21;
 }
 
 void Group::get_version_and_history_info(const Array& top, _impl::History::version_type& version, int& history_type,
@@ -379,7 +379,7 @@ void Transaction::upgrade_file_format(int target_file_format_version)
     // Be sure to revisit the following upgrade logic when a new file format
     // version is introduced. The following assert attempt to help you not
     // forget it.
-    REALM_ASSERT_EX(target_file_format_version == 20, target_file_format_version);
+    REALM_ASSERT_EX(target_file_format_version == 21, target_file_format_version);
 
     int current_file_format_version = get_file_format_version();
     REALM_ASSERT(current_file_format_version < target_file_format_version);
@@ -387,7 +387,8 @@ void Transaction::upgrade_file_format(int target_file_format_version)
     // DB::do_open() must ensure this. Be sure to revisit the
     // following upgrade logic when DB::do_open() is changed (or
     // vice versa).
-    REALM_ASSERT_EX(current_file_format_version >= 5 && current_file_format_version <= 11,
+    REALM_ASSERT_EX((current_file_format_version >= 5 && current_file_format_version <= 11) ||
+                        current_file_format_version == 20,
                     current_file_format_version);
 
 
@@ -525,6 +526,10 @@ void Transaction::upgrade_file_format(int target_file_format_version)
         }
     }
 
+    // Upgrade from version 20 (full-text index) requires no changes to the
+    // data; only the version number is raised, so that older versions of the
+    // core library refuse to open files that may contain a full-text index.
+
     // NOTE: Additional future upgrade steps go here.
 }
 
@@ -547,6 +552,7 @@ void Group::open(ref_type top_ref, const std::string& file_path)
             break;
         case 11:
         case 20:
+        case 21:
             file_format_ok = true;
             break;
     }
@@ -561,8 +567,11 @@ void Group::open(ref_type top_ref, const std::string& file_path)
     else {
         // From a technical point of view, we could upgrade the Realm file
         // format in memory here, but since upgrading can be expensive, it is
-        // currently disallowed.
-        REALM_ASSERT(target_file_format_version == m_file_format_version);
+        // currently disallowed. Version 20 files need no conversion to be
+        // read as version 21; the version is raised if a full-text index is
+        // added (see Table::add_fulltext_index()).
+        REALM_ASSERT(target_file_format_version == m_file_format_version ||
+                     (m_file_format_version == 20 && target_file_format_version == 21));
     }
 
     // Make all dynamically allocated memory (space beyond the attached file) as
@@ -782,6 +791,24 @@ void Group::attach_shared(ref_type new_top_ref, size_t new_file_size, bool writa
 }
 
 
+void Group::reattach_shared(ref_type new_top_ref, size_t new_file_size, bool writable)
+{
+    if (!is_attached()) {
+        attach_shared(new_top_ref, new_file_size, writable); // Throws
+        return;
+    }
+
+    // As advance_transact(), but without a changeset, so no schema change
+    // notification is sent.
+    m_alloc.update_reader_view(new_file_size); // Throws
+    update_allocator_wrappers(writable);
+    m_top.detach();
+    bool create_group_when_missing = false;
+    attach(new_top_ref, writable, create_group_when_missing); // Throws
+    refresh_dirty_accessors();                                // Throws
+}
+
+
 void Group::detach_table_accessors() noexcept
 {
     for (auto& table_accessor : m_table_accessors) {
@@ -794,6 +821,17 @@ void Group::detach_table_accessors() noexcept
 }
 
 
+void Group::invalidate_table_refs() noexcept
+{
+    for (Table* t : m_table_accessors) {
+        if (t) {
+            t->detach(); // bumps the instance version
+            t->m_own_ref = TableRef(t, t->m_alloc.get_instance_version());
+        }
+    }
+}
+
+
 void Group::create_empty_group()
 {
     m_top.create(Array::type_HasRefs); // Throws
@@ -696,6 +696,12 @@ private:
     /// write transaction.
     void attach_shared(ref_type new_top_ref, size_t new_file_size, bool writable);
 
+    /// Same as attach_shared(), but if this group accessor is still attached
+    /// to an earlier snapshot, the table accessors of tables which still exist
+    /// are refreshed and kept. The new snapshot must not be older than the
+    /// attached one, as accessors can only be refreshed forwards.
+    void reattach_shared(ref_type new_top_ref, size_t new_file_size, bool writable);
+
     void create_empty_group();
     void remove_table(size_t table_ndx, TableKey key);
 
@@ -737,6 +743,10 @@ private:
 
     void detach_table_accessors() noexcept; // Idempotent
 
+    /// Make every TableRef handed out so far, and every accessor derived from
+    /// one, report that it is detached, while keeping the table accessors.
+    void invalidate_table_refs() noexcept;
+
     void mark_all_table_accessors() noexcept;
 
     void write(util::File& file, const char* encryption_key, uint_fast64_t version_number, bool write_history) const;
@@ -819,6 +829,8 @@ private:
     ///
     ///  20 New data types: Decimal128 and ObjectId. Embedded tables.
     ///
+    ///  21 Full-text index on string columns (col_attr_FullText).
+    ///
     /// IMPORTANT: When introducing a new file format version, be sure to review
     /// the file validity checks in Group::open() and DB::do_open, the file
     /// format selection logic in
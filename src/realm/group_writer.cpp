@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <algorithm>
+#include <limits>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -549,6 +550,24 @@ void GroupWriter::read_in_freelist()
             free_in_file.emplace_back(ref, size, 0);
         }
 
+        if (!m_not_free_in_file.empty() && !m_bound_versions.empty()) {
+            if (m_reclaim_unbound_versions)
+                reclaim_space_of_unbound_versions(free_in_file);
+
+            // Attribute what is still locked to the newest bound version which
+            // can see it. A chunk released at version V is no longer part of V,
+            // so that is the newest bound version strictly before V.
+            m_locked_space_per_version.resize(m_bound_versions.size());
+            for (const auto& entry : m_not_free_in_file) {
+                auto it = std::lower_bound(m_bound_versions.begin(), m_bound_versions.end(),
+                                           entry.released_at_version, [](const BoundVersion& bound, uint64_t v) {
+                                               return bound.version < v;
+                                           });
+                if (it != m_bound_versions.begin())
+                    m_locked_space_per_version[size_t(it - m_bound_versions.begin()) - 1] += entry.size;
+            }
+        }
+
         // This will imply a copy-on-write
         m_free_positions.clear();
         m_free_lengths.clear();
@@ -571,6 +590,82 @@ void GroupWriter::read_in_freelist()
     free_in_file.move_free_in_file_to_size_map(m_size_map);
 }
 
+void GroupWriter::reclaim_space_of_unbound_versions(FreeList& free_in_file)
+{
+    // A chunk which was released at version V may be in use by the versions
+    // before V. Of those, only the bound ones matter, as all others are gone
+    // or can no longer be bound. A bound version does not use a chunk if the
+    // chunk is free in its own free list, or lies beyond its file size.
+    using Range = std::pair<size_t, size_t>; // [begin, end)
+    std::vector<std::vector<Range>> unused_space;
+    unused_space.reserve(m_bound_versions.size());
+    for (const auto& bound : m_bound_versions) {
+        std::vector<Range> ranges;
+        if (bound.top_ref) {
+            Array top(m_alloc);
+            top.init_from_ref(bound.top_ref);
+            if (top.size() > 5) {
+                Array positions(m_alloc);
+                Array lengths(m_alloc);
+                positions.init_from_ref(top.get_as_ref(3));
+                lengths.init_from_ref(top.get_as_ref(4));
+                size_t n = positions.size();
+                ranges.reserve(n + 1);
+                for (size_t i = 0; i < n; ++i) {
+                    size_t pos = size_t(positions.get(i));
+                    ranges.emplace_back(pos, pos + size_t(lengths.get(i)));
+                }
+            }
+        }
+        ranges.emplace_back(bound.file_size, std::numeric_limits<size_t>::max());
+        std::sort(ranges.begin(), ranges.end());
+        // merge adjacent ranges, so that a chunk spanning several of them is found
+        size_t last = 0;
+        for (size_t i = 1; i < ranges.size(); ++i) {
+            if (ranges[i].first <= ranges[last].second) {
+                ranges[last].second = std::max(ranges[last].second, ranges[i].second);
+            }
+            else {
+                ranges[++last] = ranges[i];
+            }
+        }
+        ranges.resize(last + 1);
+        unused_space.push_back(std::move(ranges));
+    }
+
+    auto is_unused = [](const std::vector<Range>& ranges, size_t ref, size_t size) {
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), Range(ref, std::numeric_limits<size_t>::max()));
+        if (it == ranges.begin())
+            return false;
+        --it;
+        return it->first <= ref && ref + size <= it->second;
+    };
+
+    auto reclaimable = [&](const FreeSpaceEntry& entry) {
+        for (size_t i = 0; i < m_bound_versions.size(); ++i) {
+            if (m_bound_versions[i].version <= entry.released_at_version &&
+                !is_unused(unused_space[i], entry.ref, entry.size))
+                return false;
+        }
+        return true;
+    };
+
+    auto it = std::stable_partition(m_not_free_in_file.begin(), m_not_free_in_file.end(),
+                                    [&](const FreeSpaceEntry& entry) {
+                                        return !reclaimable(entry);
+                                    });
+    for (auto i = it; i != m_not_free_in_file.end(); ++i) {
+        free_in_file.emplace_back(i->ref, i->size, 0);
+        m_reclaimed_space_size += i->size;
+    }
+    if (it != m_not_free_in_file.end()) {
+        m_not_free_in_file.erase(it, m_not_free_in_file.end());
+        std::sort(free_in_file.begin(), free_in_file.end(), [](const FreeSpaceEntry& a, const FreeSpaceEntry& b) {
+            return a.ref < b.ref;
+        });
+    }
+}
+
 size_t GroupWriter::recreate_freelist(size_t reserve_pos)
 {
     std::vector<FreeSpaceEntry> free_in_file;
@@ -22,6 +22,7 @@
 #include <cstdint> // unint8_t etc
 #include <utility>
 #include <map>
+#include <vector>
 
 #include <realm/util/file.hpp>
 #include <realm/alloc.hpp>
@@ -58,6 +59,35 @@ public:
 
     void set_versions(uint64_t current, uint64_t read_lock) noexcept;
 
+    /// A version which is bound by a reader, identified by the top ref and
+    /// the logical file size of its snapshot.
+    struct BoundVersion {
+        uint64_t version;
+        ref_type top_ref;
+        size_t file_size;
+    };
+
+    /// Set the versions from the oldest bound one up to, but not including,
+    /// the version the write transaction is based on, which are still bound
+    /// by readers, in increasing order. If \a reclaim is true, space released
+    /// after the oldest bound version is reused if none of these versions
+    /// can reach it. This requires that versions between them which are not
+    /// bound have been made unavailable to readers.
+    void set_bound_versions(std::vector<BoundVersion> versions, bool reclaim)
+    {
+        m_bound_versions = std::move(versions);
+        m_reclaim_unbound_versions = reclaim;
+    }
+
+    /// For each of the versions passed to set_bound_versions(), the space
+    /// which stays locked until that version is released, that is the space
+    /// released since that version, but before the next newer bound one.
+    /// Available after write_group().
+    const std::vector<size_t>& get_locked_space_per_version() const
+    {
+        return m_locked_space_per_version;
+    }
+
     /// Write all changed array nodes into free space.
     ///
     /// Returns the new top ref. When in full durability mode, call
@@ -87,6 +117,13 @@ public:
         return m_locked_space_size;
     }
 
+    /// Space released after the oldest bound version, which was made
+    /// available for reuse because no bound version can reach it.
+    size_t get_reclaimed_space_size() const
+    {
+        return m_reclaimed_space_size;
+    }
+
 private:
     class MapWindow;
     Group& m_group;
@@ -99,7 +136,11 @@ private:
     size_t m_window_alignment;
     size_t m_free_space_size = 0;
     size_t m_locked_space_size = 0;
+    size_t m_reclaimed_space_size = 0;
     Durability m_durability;
+    std::vector<BoundVersion> m_bound_versions;
+    bool m_reclaim_unbound_versions = false;
+    std::vector<size_t> m_locked_space_per_version;
 
     struct FreeSpaceEntry {
         FreeSpaceEntry(size_t r, size_t s, uint64_t v)
@@ -126,6 +167,9 @@ private:
     using FreeListElement = std::multimap<size_t, size_t>::iterator;
 
     void read_in_freelist();
+    // Move entries of m_not_free_in_file which none of m_bound_versions can
+    // reach to 'free_in_file'
+    void reclaim_space_of_unbound_versions(FreeList& free_in_file);
     size_t recreate_freelist(size_t reserve_pos);
     // Currently cached memory mappings. We keep as many as 16 1MB windows
     // open for writing. The allocator will favor sequential allocation
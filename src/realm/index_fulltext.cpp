@@ -0,0 +1,362 @@
+/*************************************************************************
+ *
+ * Copyright 2020 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+
+#include <realm/index_fulltext.hpp>
+#include <realm/column_integer.hpp>
+#include <realm/impl/destroy_guard.hpp>
+
+using namespace realm;
+
+namespace {
+
+inline bool is_word_char(char c) noexcept
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    return u >= 0x80 || (u >= '0' && u <= '9') || (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z');
+}
+
+std::string fold_word(const char* begin, const char* end)
+{
+    std::string word(begin, end);
+    for (char& c : word) {
+        if (c >= 'A' && c <= 'Z')
+            c = char(c - 'A' + 'a');
+    }
+    return word;
+}
+
+// Calls `func(word, enclosed)` for every word of `text`. A word is enclosed
+// if it is preceded and followed by a separator within `text`.
+template <class F>
+void for_each_word(StringData text, F&& func)
+{
+    if (text.is_null())
+        return;
+    const char* const begin = text.data();
+    const char* const end = begin + text.size();
+    const char* p = begin;
+    while (p < end) {
+        while (p < end && !is_word_char(*p))
+            ++p;
+        const char* word_begin = p;
+        while (p < end && is_word_char(*p))
+            ++p;
+        if (p > word_begin)
+            func(fold_word(word_begin, p), word_begin != begin && p != end);
+    }
+}
+
+void sort_and_unique(std::vector<std::string>& words)
+{
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+}
+
+} // anonymous namespace
+
+FullTextIndex::FullTextIndex(const ClusterColumn& target_column, Allocator& alloc)
+    : m_top(alloc)
+    , m_words(alloc)
+    , m_postings(alloc)
+    , m_target_column(target_column)
+{
+    m_top.create(Array::type_HasRefs, false, 2, 0); // Throws
+    _impl::DeepArrayDestroyGuard dg(&m_top);
+    m_words.set_parent(&m_top, 0);
+    m_postings.set_parent(&m_top, 1);
+    m_words.create();    // Throws
+    m_postings.create(); // Throws
+    dg.release();
+}
+
+FullTextIndex::FullTextIndex(ref_type ref, ArrayParent* parent, size_t ndx_in_parent,
+                             const ClusterColumn& target_column, Allocator& alloc)
+    : m_top(alloc)
+    , m_words(alloc)
+    , m_postings(alloc)
+    , m_target_column(target_column)
+{
+    m_top.init_from_ref(ref);
+    m_top.set_parent(parent, ndx_in_parent);
+    init_trees();
+}
+
+void FullTextIndex::init_trees()
+{
+    m_words.set_parent(&m_top, 0);
+    m_postings.set_parent(&m_top, 1);
+    m_words.init_from_parent();
+    m_postings.init_from_parent();
+}
+
+void FullTextIndex::destroy() noexcept
+{
+    m_top.destroy_deep();
+}
+
+void FullTextIndex::set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept
+{
+    m_top.set_parent(parent, ndx_in_parent);
+}
+
+void FullTextIndex::update_from_parent() noexcept
+{
+    m_top.update_from_parent();
+    init_trees();
+}
+
+void FullTextIndex::refresh_accessor_tree(const ClusterColumn& target_column)
+{
+    m_top.init_from_parent();
+    init_trees();
+    m_target_column = target_column;
+}
+
+std::vector<std::string> FullTextIndex::tokenize(StringData text)
+{
+    std::vector<std::string> words;
+    for_each_word(text, [&](std::string&& word, bool) {
+        words.push_back(std::move(word));
+    });
+    sort_and_unique(words);
+    return words;
+}
+
+std::vector<std::string> FullTextIndex::enclosed_words(StringData text)
+{
+    std::vector<std::string> words;
+    for_each_word(text, [&](std::string&& word, bool enclosed) {
+        if (enclosed)
+            words.push_back(std::move(word));
+    });
+    sort_and_unique(words);
+    return words;
+}
+
+bool FullTextIndex::contains_words(StringData text, const std::vector<std::string>& words)
+{
+    if (words.empty())
+        return true;
+    auto text_words = tokenize(text);
+    return std::includes(text_words.begin(), text_words.end(), words.begin(), words.end());
+}
+
+std::vector<std::string> FullTextIndex::get_words(ObjKey key) const
+{
+    StringConversionBuffer buffer;
+    return tokenize(m_target_column.get_index_data(key, buffer));
+}
+
+// Returns the position of the first word not less than `word`
+size_t FullTextIndex::find_word(StringData word) const
+{
+    size_t lo = 0;
+    size_t hi = m_words.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (m_words.get(mid) < word) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void FullTextIndex::add_key(StringData word, ObjKey key)
+{
+    Allocator& alloc = get_alloc();
+    size_t ndx = find_word(word);
+    if (ndx == m_words.size() || m_words.get(ndx) != word) {
+        IntegerColumn list(alloc);
+        list.create();       // Throws
+        list.add(key.value); // Throws
+        _impl::DeepArrayRefDestroyGuard dg(list.get_ref(), alloc);
+        m_postings.insert(ndx, list.get_ref()); // Throws
+        dg.release();
+        m_words.insert(ndx, word); // Throws
+        return;
+    }
+
+    ref_type ref = m_postings.get(ndx);
+    IntegerColumn list(alloc, ref);
+    // Objects are mostly created in ascending key order
+    if (list.back() < key.value) {
+        list.add(key.value); // Throws
+    }
+    else {
+        auto it = std::lower_bound(list.cbegin(), list.cend(), key.value);
+        if (it != list.cend() && *it == key.value)
+            return;
+        list.insert(it.get_position(), key.value); // Throws
+    }
+    if (list.get_ref() != ref)
+        m_postings.set(ndx, list.get_ref()); // Throws
+}
+
+void FullTextIndex::remove_key(StringData word, ObjKey key)
+{
+    size_t ndx = find_word(word);
+    REALM_ASSERT_DEBUG(ndx < m_words.size() && m_words.get(ndx) == word);
+    if (ndx == m_words.size() || m_words.get(ndx) != word)
+        return;
+
+    ref_type ref = m_postings.get(ndx);
+    IntegerColumn list(get_alloc(), ref);
+    auto it = std::lower_bound(list.cbegin(), list.cend(), key.value);
+    REALM_ASSERT_DEBUG(it != list.cend() && *it == key.value);
+    if (it == list.cend() || *it != key.value)
+        return;
+
+    if (list.size() == 1) {
+        // Last object with this word
+        list.destroy();
+        m_postings.erase(ndx); // Throws
+        m_words.erase(ndx);    // Throws
+        return;
+    }
+    list.erase(it.get_position()); // Throws
+    if (list.get_ref() != ref)
+        m_postings.set(ndx, list.get_ref()); // Throws
+}
+
+void FullTextIndex::insert(ObjKey key, StringData value)
+{
+    for (auto& word : tokenize(value)) {
+        add_key(word, key); // Throws
+    }
+}
+
+void FullTextIndex::set(ObjKey key, StringData new_value)
+{
+    auto old_words = get_words(key);
+    auto new_words = tokenize(new_value);
+
+    // Only words which are not in both values need to be updated
+    std::vector<std::string> removed;
+    std::set_difference(old_words.begin(), old_words.end(), new_words.begin(), new_words.end(),
+                        std::back_inserter(removed));
+    std::vector<std::string> added;
+    std::set_difference(new_words.begin(), new_words.end(), old_words.begin(), old_words.end(),
+                        std::back_inserter(added));
+
+    for (auto& word : removed) {
+        remove_key(word, key); // Throws
+    }
+    for (auto& word : added) {
+        add_key(word, key); // Throws
+    }
+}
+
+void FullTextIndex::erase(ObjKey key)
+{
+    for (auto& word : get_words(key)) {
+        remove_key(word, key); // Throws
+    }
+}
+
+void FullTextIndex::clear()
+{
+    m_words.destroy();
+    m_postings.destroy();
+    m_words.create();    // Throws
+    m_postings.create(); // Throws
+}
+
+void FullTextIndex::find_all(std::vector<ObjKey>& result, const std::vector<std::string>& words) const
+{
+    result.clear();
+
+    // Start with the shortest posting list, as the result can only become smaller
+    std::vector<ref_type> lists;
+    for (auto& word : words) {
+        size_t ndx = find_word(word);
+        if (ndx == m_words.size() || m_words.get(ndx) != word)
+            return;
+        lists.push_back(m_postings.get(ndx));
+    }
+    if (lists.empty())
+        return;
+
+    Allocator& alloc = get_alloc();
+    auto list_size = [&](ref_type ref) {
+        return IntegerColumn(alloc, ref).size();
+    };
+    std::sort(lists.begin(), lists.end(), [&](ref_type a, ref_type b) {
+        return list_size(a) < list_size(b);
+    });
+
+    IntegerColumn first(alloc, lists[0]);
+    result.reserve(first.size());
+    first.traverse([&](BPlusTreeNode* node, size_t) {
+        auto leaf = static_cast<IntegerColumn::LeafNode*>(node);
+        size_t sz = leaf->size();
+        for (size_t i = 0; i < sz; i++) {
+            result.emplace_back(leaf->get(i));
+        }
+        return false;
+    });
+
+    for (size_t l = 1; l < lists.size() && !result.empty(); ++l) {
+        IntegerColumn list(alloc, lists[l]);
+        auto it = list.cbegin();
+        auto end = list.cend();
+        auto out = result.begin();
+        for (ObjKey key : result) {
+            it = std::lower_bound(it, end, key.value);
+            if (it == end)
+                break;
+            if (*it == key.value)
+                *out++ = key;
+        }
+        result.erase(out, result.end());
+    }
+}
+
+size_t FullTextIndex::count(StringData word) const
+{
+    size_t ndx = find_word(word);
+    if (ndx == m_words.size() || m_words.get(ndx) != word)
+        return 0;
+    return IntegerColumn(get_alloc(), m_postings.get(ndx)).size();
+}
+
+void FullTextIndex::verify() const
+{
+#ifdef REALM_DEBUG
+    m_top.verify();
+    m_words.verify();
+    m_postings.verify();
+    size_t sz = m_words.size();
+    REALM_ASSERT(m_postings.size() == sz);
+    for (size_t i = 0; i < sz; ++i) {
+        if (i > 0)
+            REALM_ASSERT(m_words.get(i - 1) < m_words.get(i));
+        IntegerColumn list(get_alloc(), m_postings.get(i));
+        list.verify();
+        size_t list_size = list.size();
+        REALM_ASSERT(list_size > 0);
+        for (size_t j = 1; j < list_size; ++j) {
+            REALM_ASSERT(list.get(j - 1) < list.get(j));
+        }
+    }
+#endif
+}
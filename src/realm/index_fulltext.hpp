@@ -0,0 +1,136 @@
+/*************************************************************************
+ *
+ * Copyright 2020 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_FULLTEXT_HPP
+#define REALM_INDEX_FULLTEXT_HPP
+
+#include <string>
+#include <vector>
+
+#include <realm/array_ref.hpp>
+#include <realm/array_string.hpp>
+#include <realm/bplustree.hpp>
+#include <realm/index_string.hpp>
+
+/*
+The FullTextIndex class is an inverted index over the words of a string column. The value of every object is split
+into words, and for each distinct word the index holds a posting list with the keys of the objects containing it.
+
+A word is a maximal sequence of ASCII letters and digits and bytes outside the ASCII range (so that UTF-8 encoded
+characters are kept inside the words). Every other character separates words. ASCII letters are folded to lower
+case, so the index can serve both case sensitive and case insensitive searches.
+
+The top array of the index holds two B+ trees of the same size:
+
+    m_top[0]: the distinct words in ascending order
+    m_top[1]: for each word a reference to its posting list
+
+The posting lists are IntegerColumns holding the object keys in ascending order. They are stored bit-packed like
+any other integer array, so the width of the entries follows the largest key in each leaf.
+
+The index is kept in the search index slot of the column in the table, and the column has the col_attr_FullText
+attribute set, which is how the two kinds of index are told apart when the table accessors are refreshed.
+*/
+
+namespace realm {
+
+class FullTextIndex {
+public:
+    FullTextIndex(const ClusterColumn& target_column, Allocator&);
+    FullTextIndex(ref_type, ArrayParent*, size_t ndx_in_parent, const ClusterColumn& target_column, Allocator&);
+
+    FullTextIndex(const FullTextIndex&) = delete;
+    FullTextIndex& operator=(const FullTextIndex&) = delete;
+
+    ColKey get_column_key() const
+    {
+        return m_target_column.get_column_key();
+    }
+
+    static bool type_supported(realm::DataType type)
+    {
+        return type == type_String;
+    }
+
+    // Accessor concept:
+    Allocator& get_alloc() const noexcept
+    {
+        return m_top.get_alloc();
+    }
+    void destroy() noexcept;
+    void set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept;
+    void update_from_parent() noexcept;
+    void refresh_accessor_tree(const ClusterColumn& target_column);
+    ref_type get_ref() const noexcept
+    {
+        return m_top.get_ref();
+    }
+
+    // FullTextIndex interface:
+
+    bool is_empty() const
+    {
+        return m_words.size() == 0;
+    }
+    size_t num_words() const
+    {
+        return m_words.size();
+    }
+
+    void insert(ObjKey key, StringData value);
+    void set(ObjKey key, StringData new_value);
+    void erase(ObjKey key);
+    void clear();
+
+    /// Find the objects containing all of `words`, which must be lower case
+    /// words as returned by tokenize(). The keys are returned in ascending order.
+    /// Nothing is found if `words` is empty.
+    void find_all(std::vector<ObjKey>& result, const std::vector<std::string>& words) const;
+    /// Number of objects containing `word`
+    size_t count(StringData word) const;
+
+    /// The distinct words of `text` in ascending order and folded to lower case.
+    static std::vector<std::string> tokenize(StringData text);
+
+    /// The words of `text` which are delimited by separators on both sides
+    /// within `text` itself. Any string containing `text` as a substring must
+    /// contain these as whole words, while the words at the ends of `text` may
+    /// be part of longer words.
+    static std::vector<std::string> enclosed_words(StringData text);
+
+    /// True if `text` contains all of `words` (as returned by tokenize())
+    static bool contains_words(StringData text, const std::vector<std::string>& words);
+
+    void verify() const;
+
+private:
+    Array m_top;
+    BPlusTree<StringData> m_words;
+    BPlusTree<ref_type> m_postings;
+    ClusterColumn m_target_column;
+
+    void init_trees();
+    size_t find_word(StringData word) const;
+    void add_key(StringData word, ObjKey key);
+    void remove_key(StringData word, ObjKey key);
+    std::vector<std::string> get_words(ObjKey key) const;
+};
+
+} // namespace realm
+
+#endif // REALM_INDEX_FULLTEXT_HPP
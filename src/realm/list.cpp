@@ -530,6 +530,19 @@ Obj LnkLst::get_object(size_t ndx) const
     return get_target_table()->get_object(k);
 }
 
+std::vector<Obj> LnkLst::get_objects() const
+{
+    std::vector<ObjKey> keys;
+    size_t sz = Lst<ObjKey>::size();
+    keys.reserve(sz);
+    for (size_t i = 0; i < sz; ++i) {
+        ObjKey k = Lst<ObjKey>::get(i);
+        if (!k.is_unresolved())
+            keys.push_back(k);
+    }
+    return get_target_table()->get_objects(keys);
+}
+
 bool LnkLst::init_from_parent() const
 {
     ConstLstIf<ObjKey>::init_from_parent();
@@ -893,6 +893,9 @@ public:
     }
 
     Obj get_object(size_t ndx) const override;
+    // Get all the target objects in list order. The targets are looked up
+    // cluster by cluster rather than one at a time.
+    std::vector<Obj> get_objects() const;
 
     Obj operator[](size_t ndx)
     {
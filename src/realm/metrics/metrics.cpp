@@ -62,18 +62,27 @@ void Metrics::start_read_transaction()
     m_pending_read = std::make_unique<TransactionInfo>(TransactionInfo::read_transaction);
 }
 
-void Metrics::start_write_transaction()
+void Metrics::start_write_transaction(nanosecond_storage_t write_lock_wait_time)
 {
     REALM_ASSERT_DEBUG(!m_pending_write);
     m_pending_write = std::make_unique<TransactionInfo>(TransactionInfo::write_transaction);
+    m_pending_write->m_write_lock_wait_time = write_lock_wait_time;
+}
+
+void Metrics::set_write_lock_hold_time(nanosecond_storage_t write_lock_hold_time)
+{
+    if (m_pending_write) {
+        m_pending_write->m_write_lock_hold_time = write_lock_hold_time;
+    }
 }
 
 void Metrics::end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
-                                   size_t num_decrypted_pages)
+                                   size_t num_decrypted_pages, PageCacheStats page_cache)
 {
     REALM_ASSERT_DEBUG(m_transaction_info);
     if (m_pending_read) {
-        m_pending_read->update_stats(total_size, free_space, num_objects, num_versions, num_decrypted_pages);
+        m_pending_read->update_stats(total_size, free_space, num_objects, num_versions, num_decrypted_pages,
+                                     page_cache);
         m_pending_read->finish_timer();
         add_transaction(*m_pending_read);
         m_pending_read.reset(nullptr);
@@ -81,11 +90,12 @@ void Metrics::end_read_transaction(size_t total_size, size_t free_space, size_t
 }
 
 void Metrics::end_write_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
-                                    size_t num_decrypted_pages)
+                                    size_t num_decrypted_pages, PageCacheStats page_cache)
 {
     REALM_ASSERT_DEBUG(m_transaction_info);
     if (m_pending_write) {
-        m_pending_write->update_stats(total_size, free_space, num_objects, num_versions, num_decrypted_pages);
+        m_pending_write->update_stats(total_size, free_space, num_objects, num_versions, num_decrypted_pages,
+                                      page_cache);
         m_pending_write->finish_timer();
         add_transaction(*m_pending_write);
         m_pending_write.reset(nullptr);
@@ -43,11 +43,14 @@ public:
     void add_transaction(TransactionInfo info);
 
     void start_read_transaction();
-    void start_write_transaction();
+    void start_write_transaction(nanosecond_storage_t write_lock_wait_time);
+    // Called when the write lock is released, which may happen before the
+    // write transaction is ended
+    void set_write_lock_hold_time(nanosecond_storage_t write_lock_hold_time);
     void end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
-                              size_t num_decrypted_pages);
+                              size_t num_decrypted_pages, PageCacheStats page_cache);
     void end_write_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
-                               size_t num_decrypted_pages);
+                               size_t num_decrypted_pages, PageCacheStats page_cache);
     static std::unique_ptr<MetricTimer> report_fsync_time(const Group& g);
     static std::unique_ptr<MetricTimer> report_write_time(const Group& g);
 
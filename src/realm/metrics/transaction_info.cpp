@@ -92,14 +92,40 @@ size_t TransactionInfo::get_num_decrypted_pages() const
     return m_num_decrypted_pages;
 }
 
+size_t TransactionInfo::get_num_page_cache_hits() const
+{
+    return m_page_cache.hits;
+}
+
+size_t TransactionInfo::get_num_page_cache_misses() const
+{
+    return m_page_cache.misses;
+}
+
+size_t TransactionInfo::get_num_page_cache_evictions() const
+{
+    return m_page_cache.evictions;
+}
+
+nanosecond_storage_t TransactionInfo::get_write_lock_wait_time_nanoseconds() const
+{
+    return m_write_lock_wait_time;
+}
+
+nanosecond_storage_t TransactionInfo::get_write_lock_hold_time_nanoseconds() const
+{
+    return m_write_lock_hold_time;
+}
+
 void TransactionInfo::update_stats(size_t disk_size, size_t free_space, size_t total_objects,
-                                   size_t available_versions, size_t num_decrypted_pages)
+                                   size_t available_versions, size_t num_decrypted_pages, PageCacheStats page_cache)
 {
     m_realm_disk_size = disk_size;
     m_realm_free_space = free_space;
     m_total_objects = total_objects;
     m_num_versions = available_versions;
     m_num_decrypted_pages = num_decrypted_pages;
+    m_page_cache = page_cache;
 }
 
 void TransactionInfo::finish_timer()
@@ -30,6 +30,12 @@ namespace metrics {
 
 class Metrics;
 
+struct PageCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
 class TransactionInfo {
 public:
     enum TransactionType { read_transaction, write_transaction };
@@ -47,6 +53,14 @@ public:
     size_t get_total_objects() const;
     size_t get_num_available_versions() const;
     size_t get_num_decrypted_pages() const;
+    // Page cache counters of an encrypted Realm file, accumulated since the file was opened
+    size_t get_num_page_cache_hits() const;
+    size_t get_num_page_cache_misses() const;
+    size_t get_num_page_cache_evictions() const;
+    // Time spent waiting for the write lock, and time the lock was held. Zero
+    // for read transactions.
+    nanosecond_storage_t get_write_lock_wait_time_nanoseconds() const;
+    nanosecond_storage_t get_write_lock_hold_time_nanoseconds() const;
 
 private:
     MetricTimerResult m_transaction_time;
@@ -60,10 +74,13 @@ private:
     TransactionType m_type;
     size_t m_num_versions;
     size_t m_num_decrypted_pages;
+    PageCacheStats m_page_cache;
+    nanosecond_storage_t m_write_lock_wait_time = 0;
+    nanosecond_storage_t m_write_lock_hold_time = 0;
 
     friend class Metrics;
     void update_stats(size_t disk_size, size_t free_space, size_t total_objects, size_t available_versions,
-                      size_t num_decrypted_pages);
+                      size_t num_decrypted_pages, PageCacheStats page_cache);
     void finish_timer();
 };
 
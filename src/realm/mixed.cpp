@@ -19,6 +19,8 @@
 #include <realm/mixed.hpp>
 #include <realm/unicode.hpp>
 
+#include <functional>
+
 namespace realm {
 
 namespace _impl {
@@ -162,6 +164,103 @@ int Mixed::compare(const Mixed& b) const
     return 0;
 }
 
+namespace {
+
+// Divide the 128 bit value `hi:lo` by 10 if it is a multiple of 10
+bool divide_by_10_if_exact(uint64_t& hi, uint64_t& lo) noexcept
+{
+    uint32_t parts[4] = {uint32_t(hi >> 32), uint32_t(hi), uint32_t(lo >> 32), uint32_t(lo)};
+    uint64_t rem = 0;
+    for (auto& part : parts) {
+        uint64_t cur = (rem << 32) | part;
+        part = uint32_t(cur / 10);
+        rem = cur % 10;
+    }
+    if (rem != 0)
+        return false;
+    hi = (uint64_t(parts[0]) << 32) | parts[1];
+    lo = (uint64_t(parts[2]) << 32) | parts[3];
+    return true;
+}
+
+// Values which compare equal, like 1.0 and 1.00, differ in their coefficient
+// and exponent, so those are normalized by stripping trailing zeros
+size_t decimal_hash(const Decimal128& d) noexcept
+{
+    uint64_t high_bits = d.raw()->w[1];
+    if ((high_bits & 0x7800000000000000ull) == 0x7800000000000000ull)
+        return 1; // Infinity or nan
+    if ((high_bits & 0x6000000000000000ull) == 0x6000000000000000ull)
+        return 0; // Non-canonical encoding, which has the value zero
+    bool sign = (high_bits >> 63) != 0;
+    int exponent = int((high_bits >> 49) & 0x3fff);
+    uint64_t hi = high_bits & 0x0001ffffffffffffull;
+    uint64_t lo = d.raw()->w[0];
+    if (hi == 0 && lo == 0)
+        return 0; // Zero of any sign and exponent
+    while (divide_by_10_if_exact(hi, lo))
+        ++exponent;
+    size_t h = std::hash<uint64_t>()(lo);
+    h = h * 31 + std::hash<uint64_t>()(hi);
+    h = h * 31 + size_t(exponent);
+    return h * 2 + (sign ? 1 : 0);
+}
+
+} // anonymous namespace
+
+size_t Mixed::hash() const
+{
+    if (is_null())
+        return 0;
+
+    size_t type_hash = size_t(get_type()) + 1;
+    size_t value_hash = 0;
+    switch (get_type()) {
+        case type_Int:
+            value_hash = std::hash<int64_t>()(get<int64_t>());
+            break;
+        case type_Bool:
+            value_hash = get<bool>() ? 1 : 0;
+            break;
+        case type_String:
+            value_hash = get<StringData>().hash();
+            break;
+        case type_Binary: {
+            BinaryData bin = get<BinaryData>();
+            value_hash = murmur2_or_cityhash(reinterpret_cast<const unsigned char*>(bin.data()), bin.size());
+            break;
+        }
+        case type_Float:
+        case type_Double: {
+            // Positive and negative zero compare equal, and nans compare by
+            // their bits, which the hash of the value as a double preserves
+            double d = get_type() == type_Float ? double(get<float>()) : get<double>();
+            value_hash = d == 0 ? 0 : std::hash<double>()(d);
+            break;
+        }
+        case type_Timestamp: {
+            Timestamp t = get<Timestamp>();
+            value_hash = std::hash<int64_t>()(t.get_seconds()) * 31 + size_t(t.get_nanoseconds());
+            break;
+        }
+        case type_ObjectId: {
+            ObjectId id = get<ObjectId>();
+            value_hash = murmur2_or_cityhash(reinterpret_cast<const unsigned char*>(&id), sizeof(id));
+            break;
+        }
+        case type_Decimal:
+            value_hash = decimal_hash(get<Decimal128>());
+            break;
+        case type_Link:
+            value_hash = std::hash<int64_t>()(get<ObjKey>().value);
+            break;
+        default:
+            REALM_ASSERT_RELEASE(false && "Hash not supported for this column type");
+            break;
+    }
+    return type_hash * 1000003 ^ value_hash;
+}
+
 // LCOV_EXCL_START
 std::ostream& operator<<(std::ostream& out, const Mixed& m)
 {
@@ -171,6 +171,10 @@ public:
 
     bool is_null() const;
     int compare(const Mixed& b) const;
+    /// Hash consistent with compare(): values comparing equal have equal
+    /// hashes. Decimal values are normalized before they are hashed, as equal
+    /// values may be represented with different exponents.
+    size_t hash() const;
     bool operator==(const Mixed& other) const
     {
         return compare(other) == 0;
@@ -31,6 +31,7 @@
 #include "realm/array_backlink.hpp"
 #include "realm/column_type_traits.hpp"
 #include "realm/index_string.hpp"
+#include "realm/index_fulltext.hpp"
 #include "realm/cluster_tree.hpp"
 #include "realm/spec.hpp"
 #include "realm/table_view.hpp"
@@ -1198,6 +1199,11 @@ Obj& Obj::set(ColKey col_key, T value, bool is_default)
     if (StringIndex* index = m_table->get_search_index(col_key)) {
         index->set<T>(m_key, value);
     }
+    if constexpr (std::is_same_v<T, StringData>) {
+        if (FullTextIndex* index = m_table->get_fulltext_index(col_key)) {
+            index->set(m_key, value);
+        }
+    }
 
     Allocator& alloc = get_alloc();
     alloc.bump_content_version();
@@ -1542,6 +1548,9 @@ Obj& Obj::set_null(ColKey col_key, bool is_default)
         if (StringIndex* index = m_table->get_search_index(col_key)) {
             index->set(m_key, null{});
         }
+        if (FullTextIndex* index = m_table->get_fulltext_index(col_key)) {
+            index->set(m_key, StringData());
+        }
 
         switch (col_type) {
             case col_type_Int:
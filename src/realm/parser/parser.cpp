@@ -183,6 +183,7 @@ struct contains : string_token_t("contains") {};
 struct begins : string_token_t("beginswith") {};
 struct ends : string_token_t("endswith") {};
 struct like : string_token_t("like") {};
+struct text : string_token_t("text") {};
 struct between : string_token_t("between") {};
 
 struct sort_prefix : seq< string_token_t("sort"), star< blank >, one< '(' > > {};
@@ -204,7 +205,7 @@ struct include : seq<string_token_t("include"), star<blank>, one<'('>,
 struct predicate_suffix_modifier : sor<sort, distinct, limit, include> {
 };
 
-struct string_oper : seq< sor< contains, begins, ends, like>, star< blank >, opt< case_insensitive > > {};
+struct string_oper : seq< sor< contains, begins, ends, like, text>, star< blank >, opt< case_insensitive > > {};
 // "=" is equality and since other operators can start with "=" we must check equal last
 struct symbolic_oper : sor< noteq, lteq, lt, gteq, gt, eq, in, between > {};
 
@@ -716,6 +717,7 @@ OPERATOR_ACTION(begins, Predicate::Operator::BeginsWith)
 OPERATOR_ACTION(ends, Predicate::Operator::EndsWith)
 OPERATOR_ACTION(contains, Predicate::Operator::Contains)
 OPERATOR_ACTION(like, Predicate::Operator::Like)
+OPERATOR_ACTION(text, Predicate::Operator::Text)
 
 template<> struct action< between >
 {
@@ -834,6 +836,69 @@ ParserResult parse(const StringData& query)
     return ParserResult{std::move(out_predicate), state.ordering_state};
 }
 
+ParserCache::ParserCache(size_t capacity)
+    : m_capacity(capacity)
+{
+    REALM_ASSERT(m_capacity > 0);
+}
+
+std::shared_ptr<const ParserResult> ParserCache::parse(const std::string& query)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(query);
+        if (it != m_index.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            ++m_hits;
+            return it->second->second;
+        }
+        ++m_misses;
+    }
+
+    // Parsing is done without holding the lock, so another thread may parse
+    // the same string meanwhile, in which case its result is kept
+    auto result = std::make_shared<const ParserResult>(realm::parser::parse(query)); // Throws
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(query);
+    if (it != m_index.end()) {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+    m_entries.emplace_front(query, result);
+    m_index[query] = m_entries.begin();
+    if (m_entries.size() > m_capacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+    return result;
+}
+
+void ParserCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+}
+
+size_t ParserCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t ParserCache::get_hit_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+size_t ParserCache::get_miss_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
 DescriptorOrderingState parse_include_path(const realm::StringData& path)
 {
     DEBUG_PRINT_TOKEN(path);
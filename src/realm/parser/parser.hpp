@@ -19,8 +19,11 @@
 #ifndef REALM_PARSER_HPP
 #define REALM_PARSER_HPP
 
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <realm/string_data.hpp>
 
@@ -100,6 +103,7 @@ struct Predicate
         EndsWith,
         Contains,
         Like,
+        Text,
         In
     };
 
@@ -158,6 +162,36 @@ ParserResult parse(const realm::StringData& query);
 
 DescriptorOrderingState parse_include_path(const realm::StringData& path);
 
+// A bounded cache of parsed query strings, which evicts the least recently
+// used entry when it is full. What a string parses to depends on neither the
+// table nor the arguments the query is applied with, so the result is shared
+// by all uses of the same string. Safe to use from multiple threads.
+class ParserCache
+{
+public:
+    explicit ParserCache(size_t capacity = 256);
+
+    // Returns the result of parsing `query`, which is only parsed if it is
+    // not in the cache. Throws like parse() if the query is invalid, in which
+    // case nothing is cached.
+    std::shared_ptr<const ParserResult> parse(const std::string& query);
+
+    void clear();
+    size_t size() const;
+    size_t get_hit_count() const;
+    size_t get_miss_count() const;
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const ParserResult>>;
+
+    mutable std::mutex m_mutex;
+    const size_t m_capacity;
+    std::list<Entry> m_entries; // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+};
+
 // run the analysis tool to check for cycles in the grammar
 // returns the number of problems found and prints some info to std::cout
 size_t analyze_grammar();
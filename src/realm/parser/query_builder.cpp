@@ -184,6 +184,8 @@ const char* operator_description(const Predicate::Operator& op)
             return "CONTAINS";
         case realm::parser::Predicate::Operator::Like:
             return "LIKE";
+        case realm::parser::Predicate::Operator::Text:
+            return "TEXT";
         case realm::parser::Predicate::Operator::In:
             return "IN";
     }
@@ -191,6 +193,21 @@ const char* operator_description(const Predicate::Operator& op)
     return "";
 }
 
+// Full-text search is only supported on a string property of the queried table against a string literal
+REALM_FORCEINLINE Query make_fulltext_query(Columns<String>& column, StringData terms)
+{
+    if (column.links_exist()) {
+        throw_logic_error("The 'TEXT' operator is not supported across links.");
+    }
+    return column.get_base_table()->where().fulltext(column.column_key(), terms);
+}
+
+template <typename LHS, typename RHS>
+REALM_FORCEINLINE Query make_fulltext_query(LHS&, RHS&)
+{
+    throw_logic_error("The 'TEXT' operator is only supported between a string property and a string literal.");
+}
+
 // (string column OR list of primitive strings) vs (string literal OR string column)
 template <typename LHS, typename RHS>
 std::enable_if_t<realm::is_any<LHS, Columns<String>, Columns<Lst<String>>>::value &&
@@ -212,6 +229,8 @@ make_string_constraint_query(const Predicate::Comparison& cmp, LHS&& lhs, RHS&&
             return lhs.not_equal(rhs, case_sensitive);
         case Predicate::Operator::Like:
             return lhs.like(rhs, case_sensitive);
+        case Predicate::Operator::Text:
+            return make_fulltext_query(lhs, rhs);
         default:
             throw_logic_error(
                 util::format("Unsupported operator '%1' for string queries.", operator_description(cmp.op)));
@@ -884,5 +903,28 @@ void apply_ordering(DescriptorOrdering& ordering, ConstTableRef target, const pa
     apply_ordering(ordering, target, state, args, mapping);
 }
 
+PreparedQuery::PreparedQuery(const std::string& query_string)
+    : m_parsed(std::make_shared<const parser::ParserResult>(parser::parse(query_string))) // Throws
+{
+}
+
+PreparedQuery::PreparedQuery(parser::ParserCache& cache, const std::string& query_string)
+    : m_parsed(cache.parse(query_string)) // Throws
+{
+}
+
+Query PreparedQuery::bind(ConstTableRef table, Arguments& arguments, parser::KeyPathMapping mapping) const
+{
+    Query query = table->where();
+    apply_predicate(query, m_parsed->predicate, arguments, mapping); // Throws
+    return query;
+}
+
+void PreparedQuery::bind_ordering(DescriptorOrdering& ordering, ConstTableRef table, Arguments& arguments,
+                                  parser::KeyPathMapping mapping) const
+{
+    apply_ordering(ordering, table, m_parsed->ordering, arguments, mapping); // Throws
+}
+
 } // namespace query_builder
 } // namespace realm
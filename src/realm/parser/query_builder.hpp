@@ -44,6 +44,8 @@ using RowExpr = BasicRowExpr<Table>;
 namespace parser {
     struct Predicate;
     struct DescriptorOrderingState;
+    struct ParserResult;
+    class ParserCache;
 }
 
 namespace query_builder {
@@ -57,6 +59,38 @@ void apply_ordering(DescriptorOrdering& ordering, ConstTableRef target, const pa
 void apply_ordering(DescriptorOrdering& ordering, ConstTableRef target, const parser::DescriptorOrderingState& state,
                     parser::KeyPathMapping mapping = parser::KeyPathMapping());
 
+// A query string which is parsed once and may then be applied to tables any
+// number of times, binding different arguments each time. When constructed
+// from a ParserCache, all prepared queries of the same string share the
+// parsed predicate and ordering. Only the parsing is saved; building the
+// query from the parse result happens on every bind(). Built queries are not
+// kept per table, because the query nodes own copies of the argument values
+// and have no way to replace them on a later bind.
+class PreparedQuery {
+public:
+    explicit PreparedQuery(const std::string& query_string);
+    PreparedQuery(parser::ParserCache& cache, const std::string& query_string);
+
+    // Build the query on `table` with `arguments` bound to the placeholders
+    // of the string. Only the parsing is shared between calls; the query
+    // nodes are built anew each time, as the argument values and the column
+    // keys they resolve to are part of them.
+    Query bind(ConstTableRef table, Arguments& arguments,
+               parser::KeyPathMapping mapping = parser::KeyPathMapping()) const;
+
+    // Apply the sort, distinct, limit and include clauses of the string.
+    void bind_ordering(DescriptorOrdering& ordering, ConstTableRef table, Arguments& arguments,
+                       parser::KeyPathMapping mapping = parser::KeyPathMapping()) const;
+
+    const parser::ParserResult& get_parser_result() const
+    {
+        return *m_parsed;
+    }
+
+private:
+    std::shared_ptr<const parser::ParserResult> m_parsed;
+};
+
 
 struct AnyContext
 {
@@ -25,8 +25,14 @@
 #include <realm/query_expression.hpp>
 #include <realm/table_view.hpp>
 #include <realm/table_tpl.hpp>
+#include <realm/util/to_string.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <unordered_map>
 
 
 using namespace realm;
@@ -916,6 +922,14 @@ Query& Query::like(ColKey column_key, StringData value, bool case_sensitive)
         add_condition<LikeIns>(column_key, value);
     return *this;
 }
+Query& Query::fulltext(ColKey column_key, StringData terms)
+{
+    m_table->check_column(column_key);
+    if (column_key.get_type() != col_type_String || column_key.get_attrs().test(col_attr_List))
+        throw_type_mismatch_error();
+    add_node(std::unique_ptr<ParentNode>(new StringNodeFulltext(terms, column_key)));
+    return *this;
+}
 
 
 // Aggregates =================================================================================
@@ -949,7 +963,7 @@ R Query::aggregate(ColKey column_key, size_t* resultcount, ObjKey* return_ndx) c
         if (!m_view) {
             auto pn = root_node();
             auto node = pn->m_children[find_best_node(pn)];
-            if (node->has_search_index()) {
+            if (use_index(node)) {
                 node->index_based_aggregate(size_t(-1), [&](ConstObj& obj) -> bool {
                     if (eval_object(obj)) {
                         st.template match<action, false>(size_t(obj.get_key().value), 0, obj.get<T>(column_key));
@@ -971,6 +985,7 @@ R Query::aggregate(ColKey column_key, size_t* resultcount, ObjKey* return_ndx) c
 
                 auto f = [column_key, &leaf, &node, &st, this](const Cluster* cluster) {
                     size_t e = cluster->node_size();
+                    node->prefetch_leaves(cluster);
                     node->set_cluster(cluster);
                     cluster->init_leaf(column_key, &leaf);
                     st.m_key_offset = cluster->get_offset();
@@ -1012,6 +1027,16 @@ size_t Query::find_best_node(ParentNode* pn) const
     return best;
 }
 
+bool Query::use_index(const ParentNode* node) const
+{
+    if (!node->has_search_index())
+        return false;
+    // Every match found through the index costs a lookup of the object,
+    // while traversing the clusters tests the objects sequentially
+    size_t matches = node->get_known_match_count();
+    return matches == not_found || matches <= m_table.unchecked_ptr()->size() / index_lookup_cost;
+}
+
 /**************************************************************************************************************
 *                                                                                                             *
 * Main entry point of a query. Schedules calls to aggregate_local                                             *
@@ -1342,6 +1367,7 @@ ObjKey Query::find()
         ObjKey key;
         auto f = [&node, &key](const Cluster* cluster) {
             size_t end = cluster->node_size();
+            node->prefetch_leaves(cluster);
             node->set_cluster(cluster);
             size_t res = node->find_first(0, end);
             if (res != not_found) {
@@ -1410,7 +1436,7 @@ void Query::find_all(ConstTableView& ret, size_t begin, size_t end, size_t limit
         else {
             auto pn = root_node();
             auto node = pn->m_children[find_best_node(pn)];
-            if (node->has_search_index()) {
+            if (use_index(node)) {
                 // translate begin/end limiters into corresponding keys
                 auto begin_key = (begin >= m_table->size()) ? ObjKey() : m_table->get_object(begin).get_key();
                 auto end_key = (end >= m_table->size()) ? ObjKey() : m_table->get_object(end).get_key();
@@ -1444,6 +1470,7 @@ void Query::find_all(ConstTableView& ret, size_t begin, size_t end, size_t limit
                     if (e > end) {
                         e = end;
                     }
+                    node->prefetch_leaves(cluster);
                     node->set_cluster(cluster);
                     st.m_key_offset = cluster->get_offset();
                     st.m_key_values = cluster->get_key_array();
@@ -1475,6 +1502,68 @@ TableView Query::find_all(size_t start, size_t end, size_t limit)
 }
 
 
+ObjKey Query::find_batch(ObjKey begin, size_t limit, std::vector<ObjKey>& keys) const
+{
+    const ClusterTree& tree = m_table.unchecked_ptr()->m_clusters;
+    Cluster leaf(0, tree.get_alloc(), tree);
+    ClusterNode::IteratorState state(leaf);
+    ParentNode* node = has_conditions() ? root_node() : nullptr;
+
+    while (tree.get_leaf(begin, state)) {
+        size_t start = state.m_current_index;
+        size_t end = leaf.node_size();
+        if (node)
+            node->set_cluster(&leaf);
+        while (start < end) {
+            size_t ndx = node ? node->find_first(start, end) : start;
+            if (ndx == not_found)
+                break;
+            keys.push_back(leaf.get_real_key(ndx));
+            start = ndx + 1;
+            if (keys.size() == limit)
+                return start < end ? leaf.get_real_key(start) : ObjKey(leaf.get_real_key(end - 1).value + 1);
+        }
+        begin = ObjKey(leaf.get_real_key(end - 1).value + 1);
+    }
+    return null_key;
+}
+
+void Query::for_each_match(util::FunctionRef<void(ConstObj&)> fn) const
+{
+    init();
+
+    if (m_view) {
+        size_t sz = m_view->size();
+        for (size_t t = 0; t < sz; t++) {
+            ConstObj obj = m_view->get_object(t);
+            if (eval_object(obj))
+                fn(obj);
+        }
+        return;
+    }
+
+    ParentNode* node = has_conditions() ? root_node() : nullptr;
+    ConstTableRef table = m_table;
+    auto f = [&](const Cluster* cluster) {
+        size_t end = cluster->node_size();
+        if (node) {
+            node->prefetch_leaves(cluster);
+            node->set_cluster(cluster);
+        }
+        size_t start = 0;
+        while (start < end) {
+            size_t ndx = node ? node->find_first(start, end) : start;
+            if (ndx == not_found)
+                break;
+            ConstObj obj(table, cluster->get_mem(), cluster->get_real_key(ndx), ndx);
+            fn(obj);
+            start = ndx + 1;
+        }
+        return false;
+    };
+    m_table->traverse_clusters(f);
+}
+
 size_t Query::do_count(size_t limit) const
 {
     if (limit == 0)
@@ -1506,7 +1595,7 @@ size_t Query::do_count(size_t limit) const
         size_t counter = 0;
         auto pn = root_node();
         auto node = pn->m_children[find_best_node(pn)];
-        if (node->has_search_index()) {
+        if (use_index(node)) {
             node->index_based_aggregate(limit, [&](ConstObj& obj) -> bool {
                 if (eval_object(obj)) {
                     ++counter;
@@ -1527,6 +1616,7 @@ size_t Query::do_count(size_t limit) const
 
         auto f = [&node, &st, this](const Cluster* cluster) {
             size_t e = cluster->node_size();
+            node->prefetch_leaves(cluster);
             node->set_cluster(cluster);
             st.m_key_offset = cluster->get_offset();
             st.m_key_values = cluster->get_key_array();
@@ -1551,6 +1641,246 @@ size_t Query::count() const
     return do_count();
 }
 
+Query::CountEstimate Query::estimate_count(size_t sample_size) const
+{
+    size_t size = m_view ? m_view->size() : m_table->size();
+    if (!has_conditions())
+        return {size, size, size, true};
+
+    sample_size = std::max(sample_size, size_t(1));
+    if (size <= sample_size) {
+        size_t cnt = do_count();
+        return {cnt, cnt, cnt, true};
+    }
+
+    init();
+    size_t upper_bound = size;
+    if (!m_view) {
+        ParentNode* pn = root_node();
+        for (ParentNode* node : pn->m_children) {
+            size_t matches = node->get_known_match_count();
+            if (matches != not_found)
+                upper_bound = std::min(upper_bound, matches);
+        }
+        // Counting the matches of an index driving the query is as cheap as
+        // evaluating the sample
+        ParentNode* best = pn->m_children[find_best_node(pn)];
+        if (use_index(best) && best->get_known_match_count() <= sample_size) {
+            size_t cnt = do_count();
+            return {cnt, cnt, cnt, true};
+        }
+    }
+
+    // Stratified sample: one object at a random position within each of
+    // sample_size equally sized parts, so that periodic data is not aliased.
+    // The generator is seeded with a constant to make estimates repeatable.
+    std::minstd_rand rng(1);
+    size_t hits = 0;
+    for (size_t i = 0; i < sample_size; ++i) {
+        size_t begin = i * size / sample_size;
+        size_t end = (i + 1) * size / sample_size;
+        size_t ndx = begin + rng() % (end - begin);
+        ConstObj obj = m_view ? m_view->get_object(ndx) : m_table->get_object(ndx);
+        if (eval_object(obj))
+            ++hits;
+    }
+
+    // Wilson score interval with a finite population correction
+    const double z = 1.96;
+    double n = double(sample_size);
+    double p = hits / n;
+    double denominator = 1 + z * z / n;
+    double center = (p + z * z / (2 * n)) / denominator;
+    double half_width = z * std::sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / denominator;
+    half_width *= std::sqrt((size - n) / (size - 1));
+
+    // The sampled objects are known to match or not to match
+    size_t lower = std::max(hits, size_t(std::max(center - half_width, 0.0) * size));
+    size_t upper = std::min(size - (sample_size - hits), size_t(std::ceil((center + half_width) * size)));
+    upper = std::min(upper, upper_bound);
+    lower = std::min(lower, upper);
+    size_t cnt = std::min(std::max(size_t(p * size + 0.5), lower), upper);
+    return {cnt, lower, upper, false};
+}
+
+namespace {
+
+// A chain of link columns leading to the column a value is read from
+class ColumnPath {
+public:
+    ColumnPath(const Table& table, const std::vector<ColKey>& columns)
+        : m_columns(columns)
+    {
+        if (columns.empty())
+            throw LogicError(LogicError::column_does_not_exist);
+        const Table* t = &table;
+        for (size_t i = 0; i + 1 < columns.size(); ++i) {
+            t->report_invalid_key(columns[i]);
+            if (columns[i].get_type() != col_type_Link)
+                throw LogicError(LogicError::type_mismatch);
+            t = t->get_link_target(columns[i]).unchecked_ptr();
+            m_targets.push_back(t);
+        }
+        t->report_invalid_key(columns.back());
+        auto type = columns.back().get_type();
+        if (columns.back().get_attrs().test(col_attr_List) || type == col_type_LinkList || type == col_type_BackLink ||
+            type == col_type_OldMixed || type == col_type_OldTable || type == col_type_OldDateTime)
+            throw LogicError(LogicError::type_mismatch);
+    }
+
+    ColumnType get_type() const
+    {
+        return m_columns.back().get_type();
+    }
+
+    Mixed get(const ConstObj& obj) const
+    {
+        ConstObj current = obj;
+        for (size_t i = 0; i < m_targets.size(); ++i) {
+            ObjKey key = current.get<ObjKey>(m_columns[i]);
+            if (!key || key.is_unresolved())
+                return Mixed();
+            current = m_targets[i]->get_object(key);
+        }
+        return current.get_any(m_columns.back());
+    }
+
+private:
+    std::vector<ColKey> m_columns;
+    std::vector<const Table*> m_targets;
+};
+
+struct GroupState {
+    size_t count = 0;
+    int64_t int_sum = 0;
+    double double_sum = 0;
+    Decimal128 decimal_sum = Decimal128(0);
+    Mixed extreme;
+};
+
+struct GroupKeyHash {
+    size_t operator()(const std::vector<Mixed>& keys) const
+    {
+        size_t h = 0;
+        for (const Mixed& key : keys)
+            h = h * 31 + key.hash();
+        return h;
+    }
+};
+
+} // anonymous namespace
+
+std::vector<Query::GroupResult> Query::group_by(const std::vector<std::vector<ColKey>>& columns,
+                                                const std::vector<GroupAggregate>& aggregates) const
+{
+    m_table.check();
+    std::vector<ColumnPath> key_paths;
+    for (auto& path : columns)
+        key_paths.emplace_back(*m_table, path);
+    std::vector<ColumnPath> value_paths;
+    for (auto& aggregate : aggregates) {
+        value_paths.emplace_back(*m_table, aggregate.path);
+        auto type = value_paths.back().get_type();
+        bool numeric = type == col_type_Int || type == col_type_Float || type == col_type_Double ||
+                       type == col_type_Decimal;
+        bool ordered = numeric || type == col_type_Timestamp;
+        if (aggregate.op == GroupOp::min || aggregate.op == GroupOp::max ? !ordered : !numeric)
+            throw LogicError(LogicError::type_mismatch);
+    }
+
+    std::vector<GroupResult> groups;
+    std::vector<GroupState> states;
+    std::unordered_map<std::vector<Mixed>, size_t, GroupKeyHash> group_ndx;
+    std::vector<Mixed> keys(key_paths.size());
+
+    for_each_match([&](ConstObj& obj) {
+        for (size_t i = 0; i < key_paths.size(); ++i)
+            keys[i] = key_paths[i].get(obj);
+        auto it = group_ndx.find(keys);
+        size_t ndx;
+        if (it == group_ndx.end()) {
+            ndx = groups.size();
+            group_ndx.emplace(keys, ndx);
+            groups.push_back({keys, 0, {}});
+            states.resize(states.size() + aggregates.size());
+        }
+        else {
+            ndx = it->second;
+        }
+        ++groups[ndx].count;
+
+        for (size_t i = 0; i < aggregates.size(); ++i) {
+            Mixed value = value_paths[i].get(obj);
+            if (value.is_null())
+                continue;
+            GroupState& state = states[ndx * aggregates.size() + i];
+            ++state.count;
+            switch (aggregates[i].op) {
+                case GroupOp::sum:
+                case GroupOp::average:
+                    switch (value.get_type()) {
+                        case type_Int:
+                            state.int_sum += value.get<int64_t>();
+                            state.double_sum += double(value.get<int64_t>());
+                            break;
+                        case type_Float:
+                            state.double_sum += value.get<float>();
+                            break;
+                        case type_Double:
+                            state.double_sum += value.get<double>();
+                            break;
+                        case type_Decimal:
+                            state.decimal_sum += value.get<Decimal128>();
+                            break;
+                        default:
+                            break;
+                    }
+                    break;
+                case GroupOp::min:
+                    if (state.count == 1 || value < state.extreme)
+                        state.extreme = value;
+                    break;
+                case GroupOp::max:
+                    if (state.count == 1 || state.extreme < value)
+                        state.extreme = value;
+                    break;
+            }
+        }
+    });
+
+    for (size_t ndx = 0; ndx < groups.size(); ++ndx) {
+        auto& values = groups[ndx].values;
+        values.reserve(aggregates.size());
+        for (size_t i = 0; i < aggregates.size(); ++i) {
+            const GroupState& state = states[ndx * aggregates.size() + i];
+            auto type = value_paths[i].get_type();
+            switch (aggregates[i].op) {
+                case GroupOp::sum:
+                    if (type == col_type_Int)
+                        values.emplace_back(state.int_sum);
+                    else if (type == col_type_Decimal)
+                        values.emplace_back(state.decimal_sum);
+                    else
+                        values.emplace_back(state.double_sum);
+                    break;
+                case GroupOp::average:
+                    if (state.count == 0)
+                        values.emplace_back();
+                    else if (type == col_type_Decimal)
+                        values.emplace_back(state.decimal_sum / state.count);
+                    else
+                        values.emplace_back(state.double_sum / state.count);
+                    break;
+                case GroupOp::min:
+                case GroupOp::max:
+                    values.push_back(state.extreme);
+                    break;
+            }
+        }
+    }
+    return groups;
+}
+
 TableView Query::find_all(const DescriptorOrdering& descriptor)
 {
 #if REALM_METRICS
@@ -1784,6 +2114,66 @@ std::string Query::get_description() const
     return get_description(state);
 }
 
+QueryCursor::QueryCursor(const Query& query, size_t batch_size)
+    : m_query(query)
+    , m_batch_size(std::max(batch_size, size_t(1)))
+{
+    m_query.m_table.check();
+}
+
+ObjKey QueryCursor::next()
+{
+    if (m_batch_pos == m_batch.size()) {
+        fetch(m_batch);
+        m_batch_pos = 0;
+        if (m_batch.empty())
+            return null_key;
+    }
+    return m_batch[m_batch_pos++];
+}
+
+bool QueryCursor::next_batch(std::vector<ObjKey>& keys)
+{
+    keys.clear();
+    // Hand out what is left of a batch started by next()
+    if (m_batch_pos < m_batch.size()) {
+        keys.assign(m_batch.begin() + m_batch_pos, m_batch.end());
+        m_batch_pos = m_batch.size();
+        return true;
+    }
+    fetch(keys);
+    return !keys.empty();
+}
+
+void QueryCursor::fetch(std::vector<ObjKey>& keys)
+{
+    keys.clear();
+    if (m_at_end)
+        return;
+
+    // Conditions cache state derived from the table, like the matches found
+    // through a search index, which must be recomputed if it has changed
+    auto version = m_query.m_table->get_content_version();
+    if (version != m_content_version) {
+        m_query.init();
+        m_content_version = version;
+    }
+
+    if (ObjList* view = m_query.m_view) {
+        size_t sz = view->size();
+        while (m_next_ndx < sz && keys.size() < m_batch_size) {
+            ConstObj obj = view->get_object(m_next_ndx++);
+            if (m_query.eval_object(obj))
+                keys.push_back(obj.get_key());
+        }
+        m_at_end = (m_next_ndx == sz);
+    }
+    else {
+        m_next_key = m_query.find_batch(m_next_key, m_batch_size, keys);
+        m_at_end = !m_next_key;
+    }
+}
+
 void Query::init() const
 {
     m_table.check();
@@ -1791,9 +2181,64 @@ void Query::init() const
         root->init(m_view == nullptr);
         std::vector<ParentNode*> vec;
         root->gather_children(vec);
+
+        // Conditions knowing their number of matches up front start out with
+        // the actual distance between matches rather than the default for
+        // their type, so that the most selective one is evaluated first
+        double size = double(m_table.unchecked_ptr()->size());
+        for (ParentNode* node : vec) {
+            size_t matches = node->get_known_match_count();
+            if (matches != not_found)
+                node->m_dD = std::max(size / (matches + 1), 1.0);
+        }
     }
 }
 
+std::string Query::explain() const
+{
+    std::string table_name = m_table ? std::string(m_table->get_name()) : "<none>";
+    std::string plan = "Table '" + table_name + "'";
+    if (!m_table)
+        return plan + "\n";
+    plan += ", " + util::to_string(m_table->size()) + " objects\n";
+
+    if (!has_conditions()) {
+        plan += "No conditions\n";
+        return plan;
+    }
+
+    init();
+    ParentNode* root = root_node();
+    std::vector<ParentNode*> nodes = root->m_children;
+    std::stable_sort(nodes.begin(), nodes.end(), [](const ParentNode* a, const ParentNode* b) {
+        return a->cost() < b->cost();
+    });
+
+    if (m_view) {
+        plan += "Evaluated for each of the " + util::to_string(m_view->size()) + " objects in the restricting view\n";
+    }
+    else if (use_index(nodes.front())) {
+        plan += "Driven by the search index of condition 1\n";
+    }
+    else {
+        plan += "Traversal of all objects\n";
+    }
+
+    util::serializer::SerialisationState state;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        ParentNode* node = nodes[i];
+        size_t matches = node->get_known_match_count();
+        std::string how = node->has_search_index() ? "index" : (matches != not_found ? "found up front" : "scan");
+        plan += util::to_string(i + 1) + ". " + node->describe(state) + ": " + how;
+        if (matches != not_found)
+            plan += ", " + util::to_string(matches) + " matches";
+        std::ostringstream cost;
+        cost << std::fixed << std::setprecision(2) << node->cost();
+        plan += ", cost " + cost.str() + "\n";
+    }
+    return plan;
+}
+
 size_t Query::find_internal(size_t start, size_t end) const
 {
     if (end == size_t(-1))
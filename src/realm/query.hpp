@@ -35,10 +35,12 @@
 #endif
 
 #include <realm/obj_list.hpp>
+#include <realm/mixed.hpp>
 #include <realm/table_ref.hpp>
 #include <realm/binary_data.hpp>
 #include <realm/timestamp.hpp>
 #include <realm/handover_defs.hpp>
+#include <realm/util/function_ref.hpp>
 #include <realm/util/serializer.hpp>
 
 namespace realm {
@@ -209,6 +211,9 @@ public:
     Query& ends_with(ColKey column_key, StringData value, bool case_sensitive = true);
     Query& contains(ColKey column_key, StringData value, bool case_sensitive = true);
     Query& like(ColKey column_key, StringData value, bool case_sensitive = true);
+    // Matches strings containing all the words of `terms`, ignoring case and
+    // word order. Uses the full-text index of the column if it has one.
+    Query& fulltext(ColKey column_key, StringData terms);
 
     // These are shortcuts for equal(StringData(c_str)) and
     // not_equal(StringData(c_str)), and are needed to avoid unwanted
@@ -245,6 +250,22 @@ public:
 
     // Aggregates
     size_t count() const;
+
+    /// Result of estimate_count(). The actual number of matches lies within
+    /// [lower, upper] with a confidence of about 95%, or is `count` if `exact`.
+    struct CountEstimate {
+        size_t count;
+        size_t lower;
+        size_t upper;
+        bool exact;
+    };
+
+    /// Estimate the number of matching objects by evaluating the query for
+    /// at most `sample_size` objects spread over the table (or the restricting
+    /// view). The number of matches known up front from a search index bounds
+    /// the estimate, and the count is exact if it is no more expensive to
+    /// compute than the sample.
+    CountEstimate estimate_count(size_t sample_size = 1000) const;
     TableView find_all(const DescriptorOrdering& descriptor);
     size_t count(const DescriptorOrdering& descriptor);
     int64_t sum_int(ColKey column_key) const;
@@ -266,6 +287,33 @@ public:
     Decimal128 minimum_decimal128(ColKey column_key, ObjKey* return_ndx = nullptr) const;
     Decimal128 average_decimal128(ColKey column_key, size_t* resultcount = nullptr) const;
 
+    // Grouped aggregates
+    enum class GroupOp { sum, min, max, average };
+    struct GroupAggregate {
+        GroupOp op;
+        // Columns to follow from the table of the query; all but the last
+        // must be links
+        std::vector<ColKey> path;
+    };
+    struct GroupResult {
+        // Values of the grouping columns, null if a link on the way is null
+        std::vector<Mixed> keys;
+        // Number of matching objects in the group
+        size_t count;
+        // Result of each aggregate. Sums of integers are Int, other sums and
+        // averages are Double, or Decimal for decimal columns. Minimum,
+        // maximum and average are null if the group has no non-null values.
+        std::vector<Mixed> values;
+    };
+
+    /// Group the matching objects by the values of `columns`, each a path of
+    /// links like for DistinctDescriptor, and compute `aggregates` for every
+    /// group, in a single pass over the matches. Groups are returned in the
+    /// order their first object was found. String and binary values refer to
+    /// the Realm file and are only valid until the next modification.
+    std::vector<GroupResult> group_by(const std::vector<std::vector<ColKey>>& columns,
+                                      const std::vector<GroupAggregate>& aggregates = {}) const;
+
     // Deletion
     size_t remove();
 
@@ -299,6 +347,12 @@ public:
     std::string get_description() const;
     std::string get_description(util::serializer::SerialisationState& state) const;
 
+    /// Describe how the query is going to be evaluated: whether a search
+    /// index, a traversal of the table or a restricting view drives it, and
+    /// the conditions in the order of their estimated cost, with how they are
+    /// evaluated and the number of matches if known up front.
+    std::string explain() const;
+
     bool eval_object(ConstObj& obj) const;
 
 private:
@@ -353,12 +407,22 @@ private:
     template <Action action, typename T, typename R>
     R aggregate(ColKey column_key, size_t* resultcount = nullptr, ObjKey* return_ndx = nullptr) const;
 
+    // A search index is only used to drive the query if matching objects are
+    // at most this many times fewer than the objects in the table
+    static constexpr size_t index_lookup_cost = 16;
+
     size_t find_best_node(ParentNode* pn) const;
+    bool use_index(const ParentNode* node) const;
     void aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start, size_t end,
                             ArrayPayload* source_column) const;
 
     void find_all(ConstTableView& tv, size_t start = 0, size_t end = size_t(-1), size_t limit = size_t(-1)) const;
+    // Append matches to `keys` until it holds `limit` keys, starting at the
+    // object with key `begin` or the one following it. Returns the key to
+    // continue from, or null_key if the end of the table was reached.
+    ObjKey find_batch(ObjKey begin, size_t limit, std::vector<ObjKey>& keys) const;
     size_t do_count(size_t limit = size_t(-1)) const;
+    void for_each_match(util::FunctionRef<void(ConstObj&)> fn) const;
     void delete_nodes() noexcept;
 
     bool has_conditions() const
@@ -378,6 +442,7 @@ private:
     friend class SubQueryCount;
     friend class PrimitiveListCount;
     friend class metrics::QueryInfo;
+    friend class QueryCursor;
 
     std::string error_code;
 
@@ -397,6 +462,40 @@ private:
     std::unique_ptr<ConstTableView> m_owned_source_table_view; // <--- except when indicated here
 };
 
+/// Pull based access to the matches of a query. The query is evaluated
+/// cluster by cluster as the matches are consumed, one batch at a time, so
+/// memory use is bounded by the batch size rather than the number of matches,
+/// and the first match is available as soon as it is found.
+///
+/// The cursor continues from the key following the last match it returned,
+/// so it may be used across modifications of the table: objects created
+/// behind that position will be found. Keys already fetched into the current
+/// batch are not rechecked and may have been deleted in the meantime.
+class QueryCursor {
+public:
+    explicit QueryCursor(const Query& query, size_t batch_size = 1000);
+
+    /// Return the key of the next match, or null_key once all matches have
+    /// been returned.
+    ObjKey next();
+
+    /// Replace the contents of `keys` with the next matches, at most batch
+    /// size of them. Returns false once all matches have been returned.
+    bool next_batch(std::vector<ObjKey>& keys);
+
+private:
+    Query m_query;
+    size_t m_batch_size;
+    std::vector<ObjKey> m_batch;
+    size_t m_batch_pos = 0;
+    ObjKey m_next_key = ObjKey(0); // Where to continue in the table
+    size_t m_next_ndx = 0;         // Where to continue in the restricting view
+    bool m_at_end = false;
+    uint_fast64_t m_content_version = uint_fast64_t(-1);
+
+    void fetch(std::vector<ObjKey>& keys);
+};
+
 // Implementation:
 
 inline Query& Query::equal(ColKey column_key, const char* c_str, bool case_sensitive)
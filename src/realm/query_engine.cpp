@@ -67,6 +67,38 @@ size_t ParentNode::find_first(size_t start, size_t end)
     return not_found;
 }
 
+void ParentNode::prefetch_leaves(const Cluster* cluster) const
+{
+    // The leaves of a cluster are normally written close to each other, so
+    // decrypting the range spanned by the keys and the condition columns in
+    // one batch is cheaper than decrypting each leaf when it is first read.
+    // Leaves far apart are left to the read barrier.
+    constexpr size_t max_prefetch_span = 256 * 1024;
+
+    const Allocator& alloc = cluster->get_alloc();
+    if (!alloc.has_encrypted_mapping())
+        return;
+
+    ref_type first = std::numeric_limits<ref_type>::max();
+    ref_type last = 0;
+    auto add = [&](size_t ndx) {
+        if (ndx >= cluster->size())
+            return;
+        RefOrTagged rot = cluster->get_as_ref_or_tagged(ndx);
+        if (rot.is_ref() && rot.get_as_ref() != 0) {
+            first = std::min(first, rot.get_as_ref());
+            last = std::max(last, rot.get_as_ref());
+        }
+    };
+    add(0); // The keys, unless they are on compact form
+    for (const ParentNode* node = this; node; node = node->m_child.get()) {
+        if (node->m_condition_column_key)
+            add(node->m_condition_column_key.get_index().val + 1);
+    }
+    if (last > first && last - first <= max_prefetch_span)
+        alloc.prefetch(first, last);
+}
+
 bool ParentNode::match(ConstObj& obj)
 {
     auto cb = [this](const Cluster* cluster, size_t row) {
@@ -549,7 +581,12 @@ void ExpressionNode::cluster_changed()
 void ExpressionNode::init(bool will_query_ranges)
 {
     ParentNode::init(will_query_ranges);
-    m_dT = m_expression->init();
+    m_dT = m_expression->init(will_query_ranges);
+}
+
+size_t ExpressionNode::get_known_match_count() const
+{
+    return m_expression->get_known_match_count();
 }
 
 std::string ExpressionNode::describe(util::serializer::SerialisationState& state) const
@@ -112,6 +112,7 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #include <realm/util/string_buffer.hpp>
 #include <realm/utilities.hpp>
 #include <realm/index_string.hpp>
+#include <realm/index_fulltext.hpp>
 
 #include <map>
 #include <unordered_set>
@@ -153,6 +154,13 @@ public:
     }
     virtual void index_based_aggregate(size_t, Evaluator) {}
 
+    // Number of objects matching this condition alone when it is known up
+    // front, e.g. from a search index, or not_found. Valid after init().
+    virtual size_t get_known_match_count() const
+    {
+        return not_found;
+    }
+
     void gather_children(std::vector<ParentNode*>& v)
     {
         m_children.clear();
@@ -214,6 +222,10 @@ public:
         cluster_changed();
     }
 
+    // Hint that the leaves read by the conditions of this node and its
+    // children are about to be scanned in the given cluster
+    void prefetch_leaves(const Cluster* cluster) const;
+
     virtual void collect_dependencies(std::vector<TableKey>&) const
     {
     }
@@ -782,6 +794,11 @@ public:
         return this->m_table->has_search_index(IntegerNodeBase<LeafType>::m_condition_column_key);
     }
 
+    size_t get_known_match_count() const override
+    {
+        return has_search_index() && m_needles.empty() ? m_result.size() : not_found;
+    }
+
     void index_based_aggregate(size_t limit, Evaluator evaluator) override
     {
         for (size_t t = 0; t < m_result.size() && limit > 0; ++t) {
@@ -1659,12 +1676,81 @@ protected:
     std::string m_lcase;
 };
 
-// Specialization for Contains condition on Strings - we specialize because we can utilize Boyer-Moore
+// Base class for string conditions which can get their candidates from the full-text index of the column.
+// The candidates are sorted by key. Subclasses decide whether each candidate must be checked against the string.
+class StringNodeFulltextBase : public StringNodeBase {
+public:
+    using StringNodeBase::StringNodeBase;
+
+    StringNodeFulltextBase(const StringNodeFulltextBase& from)
+        : StringNodeBase(from)
+    {
+    }
+
+    bool has_search_index() const override
+    {
+        return m_has_fulltext_index;
+    }
+
+    size_t get_known_match_count() const override
+    {
+        return m_has_fulltext_index ? m_index_matches.size() : not_found;
+    }
+
+    void index_based_aggregate(size_t limit, Evaluator evaluator) override
+    {
+        for (size_t i = 0; i < m_index_matches.size() && limit > 0; ++i) {
+            auto obj = m_table->get_object(m_index_matches[i]);
+            if (evaluator(obj)) {
+                --limit;
+            }
+        }
+    }
+
+protected:
+    std::vector<ObjKey> m_index_matches;
+    bool m_has_fulltext_index = false;
+
+    // Look up the objects containing all of `words` if the column has a full-text index
+    void fulltext_index_init(const std::vector<std::string>& words)
+    {
+        m_index_matches.clear();
+        m_has_fulltext_index = false;
+        if (words.empty())
+            return;
+        if (FullTextIndex* index = m_table.unchecked_ptr()->get_fulltext_index(m_condition_column_key)) {
+            index->find_all(m_index_matches, words);
+            m_has_fulltext_index = true;
+            m_dT = 0.0;
+        }
+    }
+
+    // Returns the first candidate in [start, end) of the current cluster accepted by `matches`
+    template <class Pred>
+    size_t find_first_candidate(size_t start, size_t end, Pred&& matches)
+    {
+        if (start >= end)
+            return not_found;
+        ObjKey first_key = m_cluster->get_real_key(start);
+        ObjKey last_key = m_cluster->get_real_key(end - 1);
+        int64_t offset = m_cluster->get_offset();
+        auto it = std::lower_bound(m_index_matches.begin(), m_index_matches.end(), first_key);
+        for (; it != m_index_matches.end() && *it <= last_key; ++it) {
+            size_t ndx = m_cluster->lower_bound_key(ObjKey(it->value - offset));
+            if (matches(ndx))
+                return ndx;
+        }
+        return not_found;
+    }
+};
+
+// Specialization for Contains condition on Strings - we specialize because we can utilize Boyer-Moore, and the
+// full-text index when the needle spans a whole word
 template <>
-class StringNode<Contains> : public StringNodeBase {
+class StringNode<Contains> : public StringNodeFulltextBase {
 public:
     StringNode(StringData v, ColKey column)
-        : StringNodeBase(v, column)
+        : StringNodeFulltextBase(v, column)
         , m_charmap()
     {
         if (v.size() == 0)
@@ -1689,6 +1775,9 @@ public:
         m_dD = 100.0;
 
         StringNodeBase::init(will_query_ranges);
+
+        // A string containing the needle contains the words enclosed in it
+        fulltext_index_init(m_value ? FullTextIndex::enclosed_words(*m_value) : std::vector<std::string>());
     }
 
 
@@ -1696,6 +1785,12 @@ public:
     {
         Contains cond;
 
+        if (m_has_fulltext_index) {
+            return find_first_candidate(start, end, [&](size_t s) {
+                return cond(StringData(m_value), m_charmap, get_string(s));
+            });
+        }
+
         for (size_t s = start; s < end; ++s) {
             StringData t = get_string(s);
 
@@ -1717,7 +1812,7 @@ public:
     }
 
     StringNode(const StringNode& from)
-        : StringNodeBase(from)
+        : StringNodeFulltextBase(from)
         , m_charmap(from.m_charmap)
     {
     }
@@ -1726,12 +1821,13 @@ protected:
     std::array<uint8_t, 256> m_charmap;
 };
 
-// Specialization for ContainsIns condition on Strings - we specialize because we can utilize Boyer-Moore
+// Specialization for ContainsIns condition on Strings - we specialize because we can utilize Boyer-Moore, and the
+// full-text index when the needle is ASCII and spans a whole word
 template <>
-class StringNode<ContainsIns> : public StringNodeBase {
+class StringNode<ContainsIns> : public StringNodeFulltextBase {
 public:
     StringNode(StringData v, ColKey column)
-        : StringNodeBase(v, column)
+        : StringNodeFulltextBase(v, column)
         , m_charmap()
     {
         auto upper = case_map(v, true);
@@ -1768,6 +1864,15 @@ public:
         m_dD = 100.0;
 
         StringNodeBase::init(will_query_ranges);
+
+        // The index folds only ASCII letters, so other characters may have case variants it does not know about
+        std::vector<std::string> words;
+        if (m_value && std::all_of(m_value->begin(), m_value->end(), [](char c) {
+                return static_cast<unsigned char>(c) < 0x80;
+            })) {
+            words = FullTextIndex::enclosed_words(*m_value);
+        }
+        fulltext_index_init(words);
     }
 
 
@@ -1775,6 +1880,12 @@ public:
     {
         ContainsIns cond;
 
+        if (m_has_fulltext_index) {
+            return find_first_candidate(start, end, [&](size_t s) {
+                return cond(StringData(m_value), m_ucase.c_str(), m_lcase.c_str(), m_charmap, get_string(s));
+            });
+        }
+
         for (size_t s = start; s < end; ++s) {
             StringData t = get_string(s);
             // The current behaviour is to return all results when querying for a null string.
@@ -1799,7 +1910,7 @@ public:
     }
 
     StringNode(const StringNode& from)
-        : StringNodeBase(from)
+        : StringNodeFulltextBase(from)
         , m_charmap(from.m_charmap)
         , m_ucase(from.m_ucase)
         , m_lcase(from.m_lcase)
@@ -1812,6 +1923,70 @@ protected:
     std::string m_lcase;
 };
 
+// Matches strings containing all the words of the search terms, as split by FullTextIndex::tokenize(). The
+// full-text index of the column gives the result directly. Without an index every string is split into words.
+class StringNodeFulltext : public StringNodeFulltextBase {
+public:
+    StringNodeFulltext(StringData terms, ColKey column)
+        : StringNodeFulltextBase(terms, column)
+        , m_words(FullTextIndex::tokenize(terms))
+    {
+    }
+
+    void init(bool will_query_ranges) override
+    {
+        clear_leaf_state();
+
+        m_dD = 100.0;
+
+        StringNodeBase::init(will_query_ranges);
+
+        fulltext_index_init(m_words);
+    }
+
+    void cluster_changed() override
+    {
+        // If we use the index, we do not need further access to clusters
+        if (!m_has_fulltext_index) {
+            StringNodeBase::cluster_changed();
+        }
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (m_has_fulltext_index) {
+            return find_first_candidate(start, end, [](size_t) {
+                return true;
+            });
+        }
+
+        for (size_t s = start; s < end; ++s) {
+            if (FullTextIndex::contains_words(get_string(s), m_words))
+                return s;
+        }
+        return not_found;
+    }
+
+    virtual std::string describe_condition() const override
+    {
+        return "TEXT";
+    }
+
+    std::unique_ptr<ParentNode> clone() const override
+    {
+        return std::unique_ptr<ParentNode>(new StringNodeFulltext(*this));
+    }
+
+    StringNodeFulltext(const StringNodeFulltext& from)
+        : StringNodeFulltextBase(from)
+        , m_words(from.m_words)
+    {
+    }
+
+private:
+    std::vector<std::string> m_words;
+};
+
 class StringNodeEqualBase : public StringNodeBase {
 public:
     StringNodeEqualBase(StringData v, ColKey column)
@@ -1831,6 +2006,11 @@ public:
         return m_has_search_index;
     }
 
+    size_t get_known_match_count() const override
+    {
+        return m_has_search_index ? m_results_end - m_results_start : not_found;
+    }
+
     void cluster_changed() override
     {
         // If we use searchindex, we do not need further access to clusters
@@ -2433,6 +2613,7 @@ public:
 
     void init(bool) override;
     size_t find_first_local(size_t start, size_t end) override;
+    size_t get_known_match_count() const override;
 
     void table_changed() override;
     void cluster_changed() override;
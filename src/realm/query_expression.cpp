@@ -18,6 +18,7 @@
 
 #include <realm/query_expression.hpp>
 #include <realm/group.hpp>
+#include <realm/table_view.hpp>
 
 namespace realm {
 
@@ -192,7 +193,9 @@ std::vector<ObjKey> LinkMap::get_origin_ndxs(ObjKey key, size_t column) const
         for (auto k : keys) {
             ConstObj o = link_table.unchecked_ptr()->get_object(k);
             if (forward_type == type_Link) {
-                ret.push_back(o.get<ObjKey>(link_col_ndx));
+                ObjKey link = o.get<ObjKey>(link_col_ndx);
+                if (link && !link.is_unresolved())
+                    ret.push_back(link);
             }
             else {
                 REALM_ASSERT(forward_type == type_LinkList);
@@ -217,6 +220,22 @@ std::vector<ObjKey> LinkMap::get_origin_ndxs(ObjKey key, size_t column) const
     return ret;
 }
 
+bool LinkMap::find_origins(Query& target_query, size_t max_target_matches, std::vector<ObjKey>& origins) const
+{
+    REALM_ASSERT(target_query.get_table() == get_target_table());
+    for (size_t i = 0; i < m_link_column_keys.size(); ++i)
+        m_tables[i]->report_invalid_key(m_link_column_keys[i]);
+    TableView matches = target_query.find_all(0, size_t(-1), max_target_matches + 1);
+    size_t sz = matches.size();
+    if (sz > max_target_matches)
+        return false;
+    for (size_t i = 0; i < sz; ++i) {
+        auto keys = get_origin_ndxs(matches.get_key(i));
+        origins.insert(origins.end(), keys.begin(), keys.end());
+    }
+    return true;
+}
+
 void Columns<Link>::evaluate(size_t index, ValueBase& destination)
 {
     // Destination must be of Key type. It only makes sense to
@@ -147,6 +147,7 @@ The Columns class encapsulates all this into a simple class that, for any type T
 
 #include <numeric>
 #include <algorithm>
+#include <unordered_map>
 
 // Normally, if a next-generation-syntax condition is supported by the old query_engine.hpp, a query_engine node is
 // created because it's faster (by a factor of 5 - 10). Because many of our existing next-generation-syntax unit
@@ -364,6 +365,8 @@ struct ValueBase {
     size_t m_values;
 };
 
+class LinkMap;
+
 class Expression {
 public:
     Expression()
@@ -373,12 +376,19 @@ public:
     {
     }
 
-    virtual double init()
+    // `will_query_ranges` is false if the query is restricted to a view, so
+    // that only few rows may be evaluated.
+    virtual double init(bool /*will_query_ranges*/)
     {
         return 50.0; // Default dT
     }
 
     virtual size_t find_first(size_t start, size_t end) const = 0;
+    // See ParentNode::get_known_match_count()
+    virtual size_t get_known_match_count() const
+    {
+        return not_found;
+    }
     virtual void set_base_table(ConstTableRef table) = 0;
     virtual void set_cluster(const Cluster*) = 0;
     virtual void collect_dependencies(std::vector<TableKey>&) const
@@ -446,6 +456,25 @@ public:
         return {};
     }
 
+    // For a column reached through links, the links leading to the target
+    // table and a copy of the column which reads the target table directly.
+    // Used to evaluate conditions on the target table and map the matches
+    // back through the backlinks.
+    virtual const LinkMap* get_link_path() const
+    {
+        return nullptr;
+    }
+
+    virtual std::unique_ptr<Subexpr> clone_for_target_table() const
+    {
+        return {};
+    }
+
+    // Called when the value is compared with a constant such that only
+    // counts up to `limit` can be told apart: a count larger than that may be
+    // reported as `limit`.
+    virtual void set_count_limit(size_t) {}
+
     virtual DataType get_type() const = 0;
 
     virtual void evaluate(size_t index, ValueBase& destination) = 0;
@@ -2195,6 +2224,12 @@ public:
 
     std::vector<ObjKey> get_origin_ndxs(ObjKey key, size_t column = 0) const;
 
+    // Run `target_query`, which must be a query on the target table, and add
+    // the keys of the objects in the base table linking to its matches to
+    // `origins`. Gives up and returns false if more than `max_target_matches`
+    // objects match in the target table.
+    bool find_origins(Query& target_query, size_t max_target_matches, std::vector<ObjKey>& origins) const;
+
     size_t count_links(size_t row) const
     {
         CountLinks counter;
@@ -2465,6 +2500,17 @@ public:
         return m_link_map;
     }
 
+    const LinkMap* get_link_path() const override
+    {
+        return links_exist() ? &m_link_map : nullptr;
+    }
+
+    std::unique_ptr<Subexpr> clone_for_target_table() const override
+    {
+        return make_subexpr<Columns<T>>(m_column_key, m_link_map.get_target_table(), std::vector<ColKey>{},
+                                        m_comparison_type);
+    }
+
     virtual std::string description(util::serializer::SerialisationState& state) const override
     {
         return state.describe_expression_type(m_comparison_type) + state.describe_columns(m_link_map, m_column_key);
@@ -3815,6 +3861,17 @@ public:
         return m_link_map;
     }
 
+    const LinkMap* get_link_path() const override
+    {
+        return links_exist() ? &m_link_map : nullptr;
+    }
+
+    std::unique_ptr<Subexpr> clone_for_target_table() const override
+    {
+        return make_subexpr<Columns<T>>(m_column_key, m_link_map.get_target_table(), std::vector<ColKey>{},
+                                        m_comparison_type);
+    }
+
     ColKey column_key() const noexcept
     {
         return m_column_key;
@@ -4024,16 +4081,35 @@ public:
         m_link_map.collect_dependencies(tables);
     }
 
+    void set_count_limit(size_t limit) override
+    {
+        m_count_limit = limit;
+    }
+
     void evaluate(size_t index, ValueBase& destination) override
     {
         std::vector<ObjKey> links = m_link_map.get_links(index);
-        // std::sort(links.begin(), links.end());
-        m_query.init();
 
-        size_t count = std::accumulate(links.begin(), links.end(), size_t(0), [this](size_t running_count, ObjKey k) {
-            ConstObj obj = m_link_map.get_target_table()->get_object(k);
-            return running_count + m_query.eval_object(obj);
-        });
+        // Origins often link to the same objects, so the result of the
+        // subquery is remembered for each target until the target table
+        // changes
+        ConstTableRef target_table = m_link_map.get_target_table();
+        auto version = target_table->get_content_version();
+        if (version != m_content_version) {
+            m_query.init();
+            m_matches.clear();
+            m_content_version = version;
+        }
+
+        size_t count = 0;
+        for (size_t i = 0; i < links.size() && count < m_count_limit; ++i) {
+            auto it = m_matches.find(links[i]);
+            if (it == m_matches.end()) {
+                ConstObj obj = target_table->get_object(links[i]);
+                it = m_matches.emplace(links[i], m_query.eval_object(obj)).first;
+            }
+            count += it->second;
+        }
 
         destination.import(Value<Int>(false, 1, size_t(count)));
     }
@@ -4058,6 +4134,9 @@ public:
 private:
     Query m_query;
     LinkMap m_link_map;
+    size_t m_count_limit = size_t(-1);
+    uint_fast64_t m_content_version = uint_fast64_t(-1);
+    std::unordered_map<ObjKey, bool> m_matches;
 };
 
 // The unused template parameter is a hack to avoid a circular dependency between table.hpp and query_expression.hpp.
@@ -4466,9 +4545,18 @@ public:
         }
     }
 
-    double init() override
+    double init(bool will_query_ranges) override
     {
         double dT = m_left_is_const ? 10.0 : 50.0;
+        m_has_matches = false;
+        if constexpr (std::is_same_v<T, Int>) {
+            // Comparing a count with a constant c only requires counting to
+            // c + 1, as all larger counts compare alike
+            if (m_left_is_const && m_left_value.m_values == 1 && !m_left_value.m_storage.is_null(0)) {
+                int64_t c = m_left_value.m_storage[0];
+                m_right->set_count_limit(c < 0 ? 0 : size_t(c) + 1);
+            }
+        }
         if (std::is_same_v<TCond, Equal> && m_left_is_const && m_right->has_search_index() &&
             m_right->get_comparison_type() == ExpressionComparisonType::Any) {
             if (m_left_value.m_storage.is_null(0)) {
@@ -4493,6 +4581,9 @@ public:
             m_index_end = m_matches.size();
             dT = 0;
         }
+        else if (m_left_is_const && will_query_ranges && find_matches_through_backlinks()) {
+            dT = 0;
+        }
 
         return dT;
     }
@@ -4517,6 +4608,11 @@ public:
         m_right->collect_dependencies(tables);
     }
 
+    size_t get_known_match_count() const override
+    {
+        return m_has_matches ? m_matches.size() : not_found;
+    }
+
     size_t find_first(size_t start, size_t end) const override
     {
         if (m_has_matches) {
@@ -4621,6 +4717,58 @@ private:
         }
     }
 
+    // A row of the target table is assumed to be this many times cheaper to
+    // scan sequentially than it is to follow a link to it
+    static constexpr size_t target_scan_factor = 4;
+
+    // If the right side is a column reached through links, the condition may
+    // instead be evaluated on the target table, after which the matches are
+    // mapped back to the base table through the backlinks. This is done if
+    // the target table is not too large compared to the base table, and
+    // gives up if too many rows match there.
+    bool find_matches_through_backlinks()
+    {
+        if constexpr (std::is_same_v<TLeft, Subexpr> && std::is_same_v<TRight, Subexpr>) {
+            const LinkMap* link_map = m_right->get_link_path();
+            if (!link_map || m_right->get_comparison_type() != ExpressionComparisonType::Any)
+                return false;
+
+            // Rows not linking to anything are not found this way, so with
+            // single links the condition must not hold for null
+            if (link_map->only_unary_links()) {
+                Value<T> null_value;
+                null_value.init(false, 1);
+                null_value.m_storage.set_null(0);
+                if (Value<T>::template compare_const<TCond>(&m_left_value, &null_value,
+                                                            ExpressionComparisonType::Any) != not_found)
+                    return false;
+            }
+
+            // Forward evaluation follows every link of every row, while each
+            // match in the target table costs a lookup when following its
+            // backlinks
+            size_t forward_cost = link_map->get_base_table()->size() * link_map->get_nb_hops();
+            if (link_map->get_target_table()->size() > forward_cost * target_scan_factor)
+                return false;
+
+            Query target_query(make_expression<Compare>(m_left->clone(), m_right->clone_for_target_table()));
+            std::vector<ObjKey> matches;
+            if (!link_map->find_origins(target_query, forward_cost / 2, matches))
+                return false;
+
+            std::sort(matches.begin(), matches.end());
+            matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+            m_matches = std::move(matches);
+            m_has_matches = true;
+            m_index_get = 0;
+            m_index_end = m_matches.size();
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+
     std::unique_ptr<TLeft> m_left;
     std::unique_ptr<TRight> m_right;
     const Cluster* m_cluster;
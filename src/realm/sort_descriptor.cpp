@@ -21,6 +21,8 @@
 #include <realm/db.hpp>
 #include <realm/util/assert.hpp>
 
+#include <unordered_set>
+
 using namespace realm;
 
 LinkPathPart::LinkPathPart(ColKey col_key, ConstTableRef source)
@@ -218,6 +220,32 @@ void DistinctDescriptor::execute(IndexPairs& v, const Sorter& predicate, const B
         v.erase(nulls, v.end());
     }
 
+    if (predicate.can_hash()) {
+        // Keep the first object of each set of equal values, which is the one
+        // with the lowest index_in_view as v is in view order. The kept
+        // objects are compacted to the front of v, and `seen` refers to them
+        // by their new position.
+        std::vector<size_t> hashes;
+        hashes.reserve(v.size());
+        for (const IP& index : v)
+            hashes.push_back(predicate.hash(index));
+        auto hash = [&](size_t ndx) { return hashes[ndx]; };
+        auto equal = [&](size_t a, size_t b) { return !predicate(v[a], v[b], false) && !predicate(v[b], v[a], false); };
+        std::unordered_set<size_t, decltype(hash), decltype(equal)> seen(v.size(), hash, equal);
+        size_t kept = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (seen.find(i) != seen.end())
+                continue;
+            if (kept != i) {
+                v[kept] = std::move(v[i]);
+                hashes[kept] = hashes[i];
+            }
+            seen.insert(kept++);
+        }
+        v.erase(v.begin() + kept, v.end());
+        return;
+    }
+
     // Sort by the columns to distinct on
     std::sort(v.begin(), v.end(), std::ref(predicate));
 
@@ -329,6 +357,26 @@ bool BaseDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
     return total_ordering ? i.index_in_view < j.index_in_view : 0;
 }
 
+size_t BaseDescriptor::Sorter::hash(IndexPair i) const
+{
+    size_t h = 0;
+    for (size_t t = 0; t < m_columns.size(); t++) {
+        const SortColumn& col = m_columns[t];
+        Mixed value;
+        if (t == 0) {
+            value = i.cached_value;
+        }
+        else if (col.translated_keys.empty()) {
+            value = col.table->get_object(i.key_for_object).get_any(col.col_key);
+        }
+        else if (!col.is_null[i.index_in_view]) {
+            value = col.table->get_object(col.translated_keys[i.index_in_view]).get_any(col.col_key);
+        }
+        h = h * 31 + value.hash();
+    }
+    return h;
+}
+
 void BaseDescriptor::Sorter::cache_first_column(IndexPairs& v)
 {
     if (m_columns.empty())
@@ -94,6 +94,18 @@ public:
         }
         void cache_first_column(IndexPairs& v);
 
+        // Hash of the values of the columns for an object. Objects which
+        // compare as neither less nor greater than each other have equal
+        // hashes. Requires the first column to be cached.
+        size_t hash(IndexPair i) const;
+        // False if equal values of a column can have different hashes
+        bool can_hash() const
+        {
+            return std::none_of(m_columns.begin(), m_columns.end(), [](auto&& col) {
+                return col.col_key.get_type() == col_type_OldMixed;
+            });
+        }
+
     private:
         struct SortColumn {
             SortColumn(const Table* t, ColKey c, bool a)
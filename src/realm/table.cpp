@@ -30,6 +30,7 @@
 #include <realm/table.hpp>
 #include <realm/alloc_slab.hpp>
 #include <realm/index_string.hpp>
+#include <realm/index_fulltext.hpp>
 #include <realm/db.hpp>
 #include <realm/replication.hpp>
 #include <realm/table_view.hpp>
@@ -374,11 +375,19 @@ void Table::remove_recursive(CascadeState& cascade_state)
         cascade_state.m_to_be_nullified.clear();
 
         auto to_delete = std::move(cascade_state.m_to_be_deleted);
-        for (auto obj : to_delete) {
-            auto table = group->get_table(obj.first);
+        // Erase the objects table by table, each table in key order
+        std::sort(to_delete.begin(), to_delete.end());
+        std::vector<ObjKey> keys;
+        for (size_t i = 0; i < to_delete.size();) {
+            TableKey table_key = to_delete[i].first;
+            keys.clear();
+            for (; i < to_delete.size() && to_delete[i].first == table_key; ++i) {
+                REALM_ASSERT(!to_delete[i].second.is_unresolved());
+                if (keys.empty() || keys.back() != to_delete[i].second)
+                    keys.push_back(to_delete[i].second);
+            }
             // This might add to the list of objects that should be deleted
-            REALM_ASSERT(!obj.second.is_unresolved());
-            table->m_clusters.erase(obj.second, cascade_state);
+            group->get_table(table_key)->m_clusters.erase(keys, cascade_state);
         }
         nullify_links(cascade_state);
     } while (!cascade_state.m_to_be_deleted.empty() || !cascade_state.m_to_be_nullified.empty());
@@ -617,7 +626,8 @@ void Table::add_search_index(ColKey col_key)
     if (m_index_accessors[column_ndx] != nullptr)
         return;
 
-    if (!StringIndex::type_supported(DataType(col_key.get_type())) || col_key.get_attrs().test(col_attr_List)) {
+    if (!StringIndex::type_supported(DataType(col_key.get_type())) || col_key.get_attrs().test(col_attr_List) ||
+        has_fulltext_index(col_key)) {
         // FIXME: This is what we used to throw, so keep throwing that for compatibility reasons, even though it
         // should probably be a type mismatch exception instead.
         throw LogicError(LogicError::illegal_combination);
@@ -670,6 +680,77 @@ void Table::remove_search_index(ColKey col_key)
     m_spec.set_column_attr(spec_ndx, attr); // Throws
 }
 
+void Table::add_fulltext_index(ColKey col_key)
+{
+    check_column(col_key);
+    size_t column_ndx = col_key.get_index().val;
+
+    // Early-out if already indexed
+    if (has_fulltext_index(col_key))
+        return;
+
+    if (!FullTextIndex::type_supported(DataType(col_key.get_type())) || col_key.get_attrs().test(col_attr_List) ||
+        has_search_index(col_key) || col_key == m_primary_key_col) {
+        throw LogicError(LogicError::illegal_combination);
+    }
+
+    // Create the index and insert ref to it
+    if (m_fulltext_accessors.size() <= column_ndx)
+        m_fulltext_accessors.resize(column_ndx + 1);
+    FullTextIndex* index = new FullTextIndex(ClusterColumn(&m_clusters, col_key), get_alloc()); // Throws
+    m_fulltext_accessors[column_ndx] = index;
+    index->set_parent(&m_index_refs, column_ndx);
+    m_index_refs.set(column_ndx, index->get_ref()); // Throws
+
+    // Older versions of the core library cannot read a full-text index, so a
+    // file containing one must have file format version 21. A Group opened
+    // on a version 20 file is the only place where it can be lower here.
+    if (Group* group = get_parent_group()) {
+        if (group->get_file_format_version() == 20)
+            group->set_file_format_version(21);
+    }
+
+    // Update spec
+    auto spec_ndx = leaf_ndx2spec_ndx(col_key.get_index());
+    auto attr = m_spec.get_column_attr(spec_ndx);
+    attr.set(col_attr_FullText);
+    m_spec.set_column_attr(spec_ndx, attr); // Throws
+
+    for (auto o : *this) {
+        index->insert(o.get_key(), o.get<StringData>(col_key)); // Throws
+    }
+}
+
+void Table::remove_fulltext_index(ColKey col_key)
+{
+    check_column(col_key);
+    auto column_ndx = col_key.get_index();
+
+    // Early-out if non-indexed
+    if (!has_fulltext_index(col_key))
+        return;
+
+    // Destroy and remove the index
+    FullTextIndex* index = m_fulltext_accessors[column_ndx.val];
+    index->destroy();
+    delete index;
+    m_fulltext_accessors[column_ndx.val] = nullptr;
+
+    m_index_refs.set(column_ndx.val, 0);
+
+    // update spec
+    auto spec_ndx = leaf_ndx2spec_ndx(column_ndx);
+    auto attr = m_spec.get_column_attr(spec_ndx);
+    attr.reset(col_attr_FullText);
+    m_spec.set_column_attr(spec_ndx, attr); // Throws
+}
+
+bool Table::is_fulltext_leaf(size_t leaf_ndx) const noexcept
+{
+    size_t spec_ndx = leaf_ndx2spec_ndx(ColKey::Idx{unsigned(leaf_ndx)});
+    return m_spec.get_column_attr(spec_ndx).test(col_attr_FullText);
+}
+
 void Table::enumerate_string_column(ColKey col_key)
 {
     check_column(col_key);
@@ -774,6 +855,10 @@ void Table::do_erase_root_column(ColKey col_key)
         m_index_refs.set(col_ndx, 0);
         delete m_index_accessors[col_ndx];
         m_index_accessors[col_ndx] = nullptr;
+        if (col_ndx < m_fulltext_accessors.size()) {
+            delete m_fulltext_accessors[col_ndx];
+            m_fulltext_accessors[col_ndx] = nullptr;
+        }
     }
     m_opposite_table.set(col_ndx, TableKey().value);
     m_opposite_column.set(col_ndx, ColKey().value);
@@ -865,6 +950,10 @@ void Table::fully_detach() noexcept
     m_opposite_table.detach();
     m_opposite_column.detach();
     m_index_accessors.clear();
+    for (auto& index : m_fulltext_accessors) {
+        delete index;
+    }
+    m_fulltext_accessors.clear();
 }
 
 
@@ -883,6 +972,10 @@ Table::~Table() noexcept
         delete index;
     }
     m_index_accessors.clear();
+    for (auto& index : m_fulltext_accessors) {
+        delete index;
+    }
+    m_fulltext_accessors.clear();
 }
 
 
@@ -891,6 +984,12 @@ bool Table::has_search_index(ColKey col_key) const noexcept
     return m_index_accessors[col_key.get_index().val] != nullptr;
 }
 
+bool Table::has_fulltext_index(ColKey col_key) const noexcept
+{
+    size_t col_ndx = col_key.get_index().val;
+    return col_ndx < m_fulltext_accessors.size() && m_fulltext_accessors[col_ndx] != nullptr;
+}
+
 void Table::migrate_column_info()
 {
     bool changes = false;
@@ -1733,12 +1832,13 @@ void Table::batch_erase_rows(const KeyColumn& keys)
     }
     else {
         CascadeState state(CascadeState::Mode::None, g);
-        for (auto k : vec) {
-            if (g) {
+        // Links to all the objects are nullified before any of them is
+        // erased, which lets the erasure proceed leaf by leaf from the back
+        if (g && for_each_backlink_column([](ColKey) { return true; })) {
+            for (auto k : vec)
                 m_clusters.nullify_links(k, state);
-            }
-            m_clusters.erase(k, state);
         }
+        m_clusters.erase(vec, state);
     }
 }
 
@@ -2309,6 +2409,11 @@ void Table::update_from_parent() noexcept
                 index->update_from_parent();
             }
         }
+        for (auto index : m_fulltext_accessors) {
+            if (index != nullptr) {
+                index->update_from_parent();
+            }
+        }
         // FIXME: REMOVE CONDITIONAL CHECKS?
         if (m_top.size() > top_position_for_opposite_table)
             m_opposite_table.update_from_parent();
@@ -2467,6 +2572,12 @@ void Table::refresh_index_accessors()
         }
     }
     m_index_accessors.resize(col_ndx_end);
+    for (size_t col_ndx = col_ndx_end; col_ndx < m_fulltext_accessors.size(); col_ndx++) {
+        delete m_fulltext_accessors[col_ndx];
+        m_fulltext_accessors[col_ndx] = nullptr;
+    }
+    if (m_fulltext_accessors.size() > col_ndx_end)
+        m_fulltext_accessors.resize(col_ndx_end);
 
     // Then eliminate/refresh/create accessors within column range
     // we can not use for_each_column() here, since the columns may have changed
@@ -2476,6 +2587,30 @@ void Table::refresh_index_accessors()
         bool has_old_accessor = m_index_accessors[col_ndx];
         ref_type ref = m_index_refs.get_as_ref(col_ndx);
 
+        // The slot may hold a full-text index instead of a search index
+        if (ref != 0 && is_fulltext_leaf(col_ndx)) {
+            if (has_old_accessor) {
+                delete m_index_accessors[col_ndx];
+                m_index_accessors[col_ndx] = nullptr;
+            }
+            if (m_fulltext_accessors.size() <= col_ndx)
+                m_fulltext_accessors.resize(col_ndx + 1);
+            auto col_key = m_leaf_ndx2colkey[col_ndx];
+            ClusterColumn virtual_col(&m_clusters, col_key);
+            if (m_fulltext_accessors[col_ndx]) {
+                m_fulltext_accessors[col_ndx]->refresh_accessor_tree(virtual_col);
+            }
+            else {
+                m_fulltext_accessors[col_ndx] =
+                    new FullTextIndex(ref, &m_index_refs, col_ndx, virtual_col, get_alloc());
+            }
+            continue;
+        }
+        if (col_ndx < m_fulltext_accessors.size() && m_fulltext_accessors[col_ndx]) {
+            delete m_fulltext_accessors[col_ndx];
+            m_fulltext_accessors[col_ndx] = nullptr;
+        }
+
         if (has_old_accessor && ref == 0) { // accessor drop
             delete m_index_accessors[col_ndx];
             m_index_accessors[col_ndx] = nullptr;
@@ -2514,6 +2649,10 @@ void Table::verify() const
     m_clusters.verify();
     if (nb_unresolved())
         m_tombstones->verify();
+    for (auto index : m_fulltext_accessors) {
+        if (index)
+            index->verify();
+    }
 #endif
 }
 
@@ -2694,6 +2833,26 @@ ObjKey Table::find_primary_key(Mixed primary_key) const
     return {};
 }
 
+std::vector<Obj> Table::get_objects(const std::vector<ObjKey>& keys)
+{
+    std::vector<Obj> objects(keys.size());
+    TableRef self = m_own_ref;
+    m_clusters.get(keys, [&](size_t i, MemRef mem, size_t index) {
+        objects[i] = Obj(self, mem, keys[i], index);
+    });
+    return objects;
+}
+
+std::vector<ConstObj> Table::get_objects(const std::vector<ObjKey>& keys) const
+{
+    std::vector<ConstObj> objects(keys.size());
+    ConstTableRef self = m_own_ref;
+    m_clusters.get(keys, [&](size_t i, MemRef mem, size_t index) {
+        objects[i] = ConstObj(self, mem, keys[i], index);
+    });
+    return objects;
+}
+
 ObjKey Table::get_objkey_from_primary_key(const Mixed& primary_key)
 {
     auto primary_key_col = get_primary_key_column();
@@ -3131,6 +3290,7 @@ ColKey Table::generate_col_key(ColumnType tp, ColumnAttrMask attr)
 {
     REALM_ASSERT(!attr.test(col_attr_Indexed));
     REALM_ASSERT(!attr.test(col_attr_Unique)); // Must not be encoded into col_key
+    REALM_ASSERT(!attr.test(col_attr_FullText));
     // FIXME: Change this to be random number mixed with the TableKey.
     int64_t col_seq_number = m_top.get_as_ref_or_tagged(top_position_for_column_key).get_as_int();
     unsigned upper = unsigned(col_seq_number ^ get_key().value);
@@ -3212,6 +3372,7 @@ void Table::set_primary_key_column(ColKey col_key)
         do_set_primary_key_column(col_key);
 
         remove_search_index(col_key);
+        remove_fulltext_index(col_key);
         rebuild_table_with_pk_column();
     }
     else {
@@ -3531,6 +3692,7 @@ ColKey Table::set_nullability(ColKey col_key, bool nullable, bool throw_on_null)
     check_column(col_key);
 
     bool si = has_search_index(col_key);
+    bool fulltext = has_fulltext_index(col_key);
     std::string column_name(get_column_name(col_key));
     auto type = col_key.get_type();
     auto attr = col_key.get_attrs();
@@ -3559,6 +3721,8 @@ ColKey Table::set_nullability(ColKey col_key, bool nullable, bool throw_on_null)
 
     if (si)
         add_search_index(new_col);
+    if (fulltext)
+        add_fulltext_index(new_col);
 
     if (is_pk_col) {
         // If we go from non nullable to nullable, no values change,
@@ -49,6 +49,7 @@ template <class>
 class BacklinkCount;
 class BinaryColumy;
 class ConstTableView;
+class FullTextIndex;
 class Group;
 class SortDescriptor;
 class StringIndex;
@@ -162,6 +163,18 @@ public:
     void add_search_index(ColKey col_key);
     void remove_search_index(ColKey col_key);
 
+    /// add_fulltext_index() adds an index of the words of the values of the
+    /// specified string column. It is used by Query::fulltext() and by
+    /// `contains` conditions whose argument spans at least one whole word. A
+    /// column can not have both a search index and a full-text index, and the
+    /// primary key column can not have a full-text index.
+    ///
+    /// remove_fulltext_index() removes the full-text index from the specified
+    /// column. It has no effect if the column has no full-text index.
+    bool has_fulltext_index(ColKey col_key) const noexcept;
+    void add_fulltext_index(ColKey col_key);
+    void remove_fulltext_index(ColKey col_key);
+
     void enumerate_string_column(ColKey col_key);
     bool is_enumerated(ColKey col_key) const noexcept;
     bool contains_unique_values(ColKey col_key) const;
@@ -257,6 +270,11 @@ public:
     {
         return m_clusters.get(ndx);
     }
+    // Get the objects with the given keys, in the same order. Each cluster is
+    // looked up once for all the keys it holds, which is faster than looking
+    // up the keys one by one.
+    std::vector<Obj> get_objects(const std::vector<ObjKey>& keys);
+    std::vector<ConstObj> get_objects(const std::vector<ObjKey>& keys) const;
     // Get object based on primary key
     Obj get_object_with_primary_key(Mixed pk);
     // Get primary key based on ObjKey
@@ -369,6 +387,14 @@ public:
             return nullptr;
         return m_index_accessors[col.get_index().val];
     }
+    // Will return pointer to full-text index accessor. Will return nullptr if no index
+    FullTextIndex* get_fulltext_index(ColKey col) const noexcept
+    {
+        report_invalid_key(col);
+        if (!has_fulltext_index(col))
+            return nullptr;
+        return m_fulltext_accessors[col.get_index().val];
+    }
     template <class T>
     ObjKey find_first(ColKey col_key, T value) const;
 
@@ -612,6 +638,9 @@ private:
     Array m_opposite_table;  // 7th slot in m_top
     Array m_opposite_column; // 8th slot in m_top
     std::vector<StringIndex*> m_index_accessors;
+    // Full-text indexes are stored in m_index_refs as well. Columns without one have
+    // null entries, and the vector may be shorter than m_index_accessors.
+    std::vector<FullTextIndex*> m_fulltext_accessors;
     ColKey m_primary_key_col;
     Replication* const* m_repl;
     static Replication* g_dummy_replication;
@@ -623,6 +652,7 @@ private:
     size_t do_set_link(ColKey col_key, size_t row_ndx, size_t target_row_ndx);
 
     void populate_search_index(ColKey col_key);
+    bool is_fulltext_leaf(size_t leaf_ndx) const noexcept;
 
     // Migration support
     void migrate_column_info();
@@ -16,6 +16,7 @@
  *
  **************************************************************************/
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <realm/util/features.h>
@@ -50,7 +51,14 @@ public:
 
     void set_file_size(off_t new_size);
 
+    // Read and decrypt `size` bytes starting at `pos`. Both must be multiples
+    // of the block size. Consecutive blocks are read from the file in batches.
+    // Returns false if any of the blocks did not contain valid data (e.g. it
+    // was never written). The remaining blocks are still decrypted.
     bool read(FileDesc fd, off_t pos, char* dst, size_t size);
+    // Encrypt and write `size` bytes starting at `pos`. Both must be multiples
+    // of the block size. The IV table entries of a batch of blocks are always
+    // written before the blocks themselves.
     void write(FileDesc fd, off_t pos, const char* src, size_t size) noexcept;
 
 private:
@@ -73,8 +81,13 @@ private:
 #elif defined(_WIN32)
     BCRYPT_KEY_HANDLE m_aes_key_handle;
 #else
-    uint8_t m_aesKey[32];
-    EVP_CIPHER_CTX* m_ctx;
+    // The key schedule is set up once for each direction, so that only the
+    // IV has to be reset for every block
+    EVP_CIPHER_CTX* m_encr_ctx;
+    EVP_CIPHER_CTX* m_decr_ctx;
+    // HMAC states after absorbing the inner and outer padded key
+    SHA256_CTX m_hmac_inner;
+    SHA256_CTX m_hmac_outer;
 #endif
 
     uint8_t m_hmacKey[32];
@@ -84,6 +97,7 @@ private:
 
     void calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const;
     bool check_hmac(const void* data, size_t len, const uint8_t* hmac) const;
+    bool read_block(FileDesc fd, off_t pos, char* dst, char* src, size_t bytes_read);
     void crypt(EncryptionMode mode, off_t pos, char* dst, const char* src, const char* stored_iv) noexcept;
     iv_table& get_iv_table(FileDesc fd, off_t data_pos) noexcept;
     void handle_error();
@@ -100,9 +114,16 @@ struct SharedFileInfo {
     std::vector<EncryptedFileMapping*> mappings;
     uint64_t last_scanned_version = 0;
     uint64_t current_version = 0;
-    size_t num_decrypted_pages = 0;
-    size_t num_reclaimed_pages = 0;
     size_t progress_index = 0;
+    // Page cache accounting. The budget is in pages, 0 means that only the
+    // global target set by the governor applies. These are only modified with
+    // the mapping mutex held, but are atomic so that statistics can be read
+    // without it.
+    std::atomic<size_t> num_decrypted_pages{0};
+    std::atomic<size_t> num_reclaimed_pages{0};
+    std::atomic<size_t> decrypted_page_budget{0};
+    std::atomic<size_t> num_page_hits{0};
+    std::atomic<size_t> num_page_misses{0};
     std::vector<ReaderInfo> readers;
 
     SharedFileInfo(const uint8_t* key, FileDesc file_descriptor);
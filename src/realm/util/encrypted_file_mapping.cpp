@@ -18,6 +18,8 @@
 
 #include <realm/util/aes_cryptor.hpp>
 #include <realm/util/file_mapper.hpp>
+#include <realm/util/errno.hpp>
+#include <realm/exceptions.hpp>
 #include <realm/utilities.hpp>
 
 #if REALM_ENABLE_ENCRYPTION
@@ -93,6 +95,10 @@ const size_t block_size = 4096;
 const size_t metadata_size = sizeof(iv_table);
 const size_t blocks_per_metadata_block = block_size / metadata_size;
 
+// Maximum number of consecutive blocks read or written with a single system
+// call. A batch never crosses a metadata block.
+const size_t max_batch_blocks = 16;
+
 // map an offset in the data to the actual location in the file
 template <typename Int>
 Int real_offset(Int pos)
@@ -123,27 +129,79 @@ off_t iv_table_pos(off_t pos)
     return off_t(metadata_block * (blocks_per_metadata_block + 1) * block_size + metadata_index * metadata_size);
 }
 
+// The file descriptor is shared by all mappings of a file, so the file
+// position must be left untouched. Positional I/O does that with a single
+// system call where available.
 void check_write(FileDesc fd, off_t pos, const void* data, size_t len)
 {
+#ifdef _WIN32
     uint64_t orig = File::get_file_pos(fd);
     File::seek_static(fd, pos);
     File::write_static(fd, static_cast<const char*>(data), len);
     File::seek_static(fd, orig);
+#else
+    const char* src = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t r = ::pwrite(fd, src, len, pos);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            int err = errno; // Eliminate any risk of clobbering
+            if (err == ENOSPC || err == EDQUOT)
+                throw OutOfDiskSpace(get_errno_msg("pwrite() failed: ", err));
+            throw std::system_error(err, std::system_category(), "pwrite() failed");
+        }
+        REALM_ASSERT_RELEASE(r != 0);
+        src += r;
+        pos += r;
+        len -= size_t(r);
+    }
+#endif
 }
 
 size_t check_read(FileDesc fd, off_t pos, void* dst, size_t len)
 {
+#ifdef _WIN32
     uint64_t orig = File::get_file_pos(fd);
     File::seek_static(fd, pos);
     size_t ret = File::read_static(fd, static_cast<char*>(dst), len);
     File::seek_static(fd, orig);
     return ret;
+#else
+    char* const dst_0 = static_cast<char*>(dst);
+    char* out = dst_0;
+    while (len > 0) {
+        ssize_t r = ::pread(fd, out, len, pos);
+        if (r == 0)
+            break;
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            int err = errno; // Eliminate any risk of clobbering
+            throw std::system_error(err, std::system_category(), "pread() failed");
+        }
+        out += r;
+        pos += r;
+        len -= size_t(r);
+    }
+    return size_t(out - dst_0);
+#endif
+}
+
+// Number of blocks, starting at data position `pos`, which can be processed
+// as one batch: they must be consecutive in the file, i.e. not separated by a
+// metadata block.
+size_t blocks_in_batch(off_t pos, size_t size)
+{
+    const size_t index = static_cast<size_t>(pos) / block_size;
+    const size_t left_in_group = blocks_per_metadata_block - (index & (blocks_per_metadata_block - 1));
+    return std::min(std::min(size / block_size, left_in_group), max_batch_blocks);
 }
 
 } // anonymous namespace
 
 AESCryptor::AESCryptor(const uint8_t* key)
-    : m_rw_buffer(new char[block_size]),
+    : m_rw_buffer(new char[block_size * max_batch_blocks]),
       m_dst_buffer(new char[block_size])
 {
 #if REALM_PLATFORM_APPLE
@@ -168,14 +226,45 @@ AESCryptor::AESCryptor(const uint8_t* key)
     ret = BCryptGenerateSymmetricKey(hAesAlg, &m_aes_key_handle, nullptr, 0, (PBYTE)key, 32, 0);
     REALM_ASSERT_RELEASE_EX(ret == 0 && "BCryptGenerateSymmetricKey()", ret);
 #else
-    m_ctx = EVP_CIPHER_CTX_new();
-
-    if (!m_ctx)
+    m_encr_ctx = EVP_CIPHER_CTX_new();
+    m_decr_ctx = EVP_CIPHER_CTX_new();
+    if (!m_encr_ctx || !m_decr_ctx) {
+        EVP_CIPHER_CTX_free(m_encr_ctx);
+        EVP_CIPHER_CTX_free(m_decr_ctx);
         handle_error();
+    }
 
-    memcpy(m_aesKey, key, 32);
+    // Expand the key once. crypt() then only needs to set the IV of each block.
+    // Use zero padding - we always write a whole page
+    if (!EVP_CipherInit_ex(m_encr_ctx, EVP_aes_256_cbc(), NULL, key, NULL, mode_Encrypt) ||
+        !EVP_CipherInit_ex(m_decr_ctx, EVP_aes_256_cbc(), NULL, key, NULL, mode_Decrypt)) {
+        EVP_CIPHER_CTX_free(m_encr_ctx);
+        EVP_CIPHER_CTX_free(m_decr_ctx);
+        handle_error();
+    }
+    EVP_CIPHER_CTX_set_padding(m_encr_ctx, 0);
+    EVP_CIPHER_CTX_set_padding(m_decr_ctx, 0);
 #endif
     memcpy(m_hmacKey, key + 32, 32);
+
+#if !REALM_PLATFORM_APPLE && !defined(_WIN32)
+    // The padded key blocks are the same for every HMAC computation, so they
+    // are hashed only once here.
+    uint8_t ipad[64];
+    for (size_t i = 0; i < 32; ++i)
+        ipad[i] = m_hmacKey[i] ^ 0x36;
+    memset(ipad + 32, 0x36, 32);
+
+    uint8_t opad[64];
+    for (size_t i = 0; i < 32; ++i)
+        opad[i] = m_hmacKey[i] ^ 0x5C;
+    memset(opad + 32, 0x5C, 32);
+
+    SHA224_Init(&m_hmac_inner);
+    SHA256_Update(&m_hmac_inner, ipad, 64);
+    SHA224_Init(&m_hmac_outer);
+    SHA256_Update(&m_hmac_outer, opad, 64);
+#endif
 }
 
 AESCryptor::~AESCryptor() noexcept
@@ -185,8 +274,8 @@ AESCryptor::~AESCryptor() noexcept
     CCCryptorRelease(m_decr);
 #elif defined(_WIN32)
 #else
-    EVP_CIPHER_CTX_cleanup(m_ctx);
-    EVP_CIPHER_CTX_free(m_ctx);
+    EVP_CIPHER_CTX_free(m_encr_ctx);
+    EVP_CIPHER_CTX_free(m_decr_ctx);
 #endif
 }
 
@@ -240,66 +329,79 @@ bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) co
 bool AESCryptor::read(FileDesc fd, off_t pos, char* dst, size_t size)
 {
     REALM_ASSERT(size % block_size == 0);
+    bool success = true;
     while (size > 0) {
-        ssize_t bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), block_size);
+        // Read as many consecutive blocks as possible with a single system call
+        size_t num_blocks = blocks_in_batch(pos, size);
+        size_t bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), num_blocks * block_size);
+
+        for (size_t i = 0; i < num_blocks; ++i) {
+            if (!read_block(fd, pos, dst, m_rw_buffer.get() + i * block_size, bytes_read))
+                success = false;
+            bytes_read -= std::min(bytes_read, block_size);
+            pos += block_size;
+            dst += block_size;
+            size -= block_size;
+        }
+    }
+    return success;
+}
 
-        if (bytes_read == 0)
-            return false;
+bool AESCryptor::read_block(FileDesc fd, off_t pos, char* dst, char* src, size_t bytes_read)
+{
+    if (bytes_read == 0)
+        return false;
+    bytes_read = std::min(bytes_read, block_size);
+
+    iv_table& iv = get_iv_table(fd, pos);
+    if (iv.iv1 == 0) {
+        // This block has never been written to, so we've just read pre-allocated
+        // space. No memset() since the code using this doesn't rely on
+        // pre-allocated space being zeroed.
+        return false;
+    }
 
-        iv_table& iv = get_iv_table(fd, pos);
-        if (iv.iv1 == 0) {
-            // This block has never been written to, so we've just read pre-allocated
-            // space. No memset() since the code using this doesn't rely on
-            // pre-allocated space being zeroed.
+    if (!check_hmac(src, bytes_read, iv.hmac1)) {
+        // Either the DB is corrupted or we were interrupted between writing the
+        // new IV and writing the data
+        if (iv.iv2 == 0) {
+            // Very first write was interrupted
             return false;
         }
 
-        if (!check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac1)) {
-            // Either the DB is corrupted or we were interrupted between writing the
-            // new IV and writing the data
-            if (iv.iv2 == 0) {
-                // Very first write was interrupted
-                return false;
-            }
-
-            if (check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac2)) {
-                // Un-bump the IV since the write with the bumped IV never actually
-                // happened
-                memcpy(&iv.iv1, &iv.iv2, 32);
-            }
-            else {
-                // If the file has been shrunk and then re-expanded, we may have
-                // old hmacs that don't go with this data. ftruncate() is
-                // required to fill any added space with zeroes, so assume that's
-                // what happened if the buffer is all zeroes
-                for (ssize_t i = 0; i < bytes_read; ++i) {
-                    if (m_rw_buffer[i] != 0)
-                        throw DecryptionFailed();
-                }
-                return false;
+        if (check_hmac(src, bytes_read, iv.hmac2)) {
+            // Un-bump the IV since the write with the bumped IV never actually
+            // happened
+            memcpy(&iv.iv1, &iv.iv2, 32);
+        }
+        else {
+            // If the file has been shrunk and then re-expanded, we may have
+            // old hmacs that don't go with this data. ftruncate() is
+            // required to fill any added space with zeroes, so assume that's
+            // what happened if the buffer is all zeroes
+            for (size_t i = 0; i < bytes_read; ++i) {
+                if (src[i] != 0)
+                    throw DecryptionFailed();
             }
+            return false;
         }
-
-        // We may expect some adress ranges of the destination buffer of
-        // AESCryptor::read() to stay unmodified, i.e. being overwritten with
-        // the same bytes as already present, and may have read-access to these
-        // from other threads while decryption is taking place.
-        //
-        // However, some implementations of AES_cbc_encrypt(), in particular
-        // OpenSSL, will put garbled bytes as an intermediate step during the
-        // operation which will lead to incorrect data being read by other
-        // readers concurrently accessing that page. Incorrect data leads to
-        // crashes.
-        //
-        // We therefore decrypt to a temporary buffer first and then copy the
-        // completely decrypted data after.
-        crypt(mode_Decrypt, pos, m_dst_buffer.get(), m_rw_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
-        memcpy(dst, m_dst_buffer.get(), block_size);
-
-        pos += block_size;
-        dst += block_size;
-        size -= block_size;
     }
+
+    // We may expect some adress ranges of the destination buffer of
+    // AESCryptor::read() to stay unmodified, i.e. being overwritten with
+    // the same bytes as already present, and may have read-access to these
+    // from other threads while decryption is taking place.
+    //
+    // However, some implementations of AES_cbc_encrypt(), in particular
+    // OpenSSL, will put garbled bytes as an intermediate step during the
+    // operation which will lead to incorrect data being read by other
+    // readers concurrently accessing that page. Incorrect data leads to
+    // crashes.
+    //
+    // We therefore decrypt to a temporary buffer first and then copy the
+    // completely decrypted data after.
+    crypt(mode_Decrypt, pos, m_dst_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
+    memcpy(dst, m_dst_buffer.get(), block_size);
     return true;
 }
 
@@ -307,28 +409,39 @@ void AESCryptor::write(FileDesc fd, off_t pos, const char* src, size_t size) noe
 {
     REALM_ASSERT(size % block_size == 0);
     while (size > 0) {
-        iv_table& iv = get_iv_table(fd, pos);
-
-        memcpy(&iv.iv2, &iv.iv1, 32);
-        do {
-            ++iv.iv1;
-            // 0 is reserved for never-been-used, so bump if we just wrapped around
-            if (iv.iv1 == 0)
+        // The IV table entries of consecutive blocks are adjacent in the
+        // metadata block, so a batch takes two system calls regardless of its
+        // size.
+        size_t num_blocks = blocks_in_batch(pos, size);
+        iv_table* first_iv = nullptr;
+        for (size_t i = 0; i < num_blocks; ++i) {
+            off_t block_pos = pos + off_t(i * block_size);
+            iv_table& iv = get_iv_table(fd, block_pos);
+            if (i == 0)
+                first_iv = &iv;
+            char* dst = m_rw_buffer.get() + i * block_size;
+
+            memcpy(&iv.iv2, &iv.iv1, 32);
+            do {
                 ++iv.iv1;
+                // 0 is reserved for never-been-used, so bump if we just wrapped around
+                if (iv.iv1 == 0)
+                    ++iv.iv1;
+
+                crypt(mode_Encrypt, block_pos, dst, src + i * block_size, reinterpret_cast<const char*>(&iv.iv1));
+                calc_hmac(dst, block_size, iv.hmac1, m_hmacKey);
+                // In the extremely unlikely case that both the old and new versions have
+                // the same hash we won't know which IV to use, so bump the IV until
+                // they're different.
+            } while (REALM_UNLIKELY(memcmp(iv.hmac1, iv.hmac2, 4) == 0));
+        }
 
-            crypt(mode_Encrypt, pos, m_rw_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
-            calc_hmac(m_rw_buffer.get(), block_size, iv.hmac1, m_hmacKey);
-            // In the extremely unlikely case that both the old and new versions have
-            // the same hash we won't know which IV to use, so bump the IV until
-            // they're different.
-        } while (REALM_UNLIKELY(memcmp(iv.hmac1, iv.hmac2, 4) == 0));
-
-        check_write(fd, iv_table_pos(pos), &iv, sizeof(iv));
-        check_write(fd, real_offset(pos), m_rw_buffer.get(), block_size);
+        check_write(fd, iv_table_pos(pos), first_iv, num_blocks * sizeof(iv_table));
+        check_write(fd, real_offset(pos), m_rw_buffer.get(), num_blocks * block_size);
 
-        pos += block_size;
-        src += block_size;
-        size -= block_size;
+        pos += num_blocks * block_size;
+        src += num_blocks * block_size;
+        size -= num_blocks * block_size;
     }
 }
 
@@ -367,19 +480,18 @@ void AESCryptor::crypt(EncryptionMode mode, off_t pos, char* dst, const char* sr
     }
 
 #else
-    if (!EVP_CipherInit_ex(m_ctx, EVP_aes_256_cbc(), NULL, m_aesKey, iv, mode))
+    // The cipher and key were set up by the constructor, so only the IV is reset here
+    EVP_CIPHER_CTX* ctx = mode == mode_Encrypt ? m_encr_ctx : m_decr_ctx;
+    if (!EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1))
         handle_error();
 
     int len;
-    // Use zero padding - we always write a whole page
-    EVP_CIPHER_CTX_set_padding(m_ctx, 0);
-
-    if (!EVP_CipherUpdate(m_ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
+    if (!EVP_CipherUpdate(ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
                           block_size))
         handle_error();
 
     // Finalize the encryption. Should not output further data.
-    if (!EVP_CipherFinal_ex(m_ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
+    if (!EVP_CipherFinal_ex(ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
         handle_error();
 #endif
 }
@@ -388,6 +500,17 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
 {
 #if REALM_PLATFORM_APPLE
     CCHmac(kCCHmacAlgSHA224, key, 32, src, len, dst);
+#elif !defined(_WIN32)
+    // Full hmac operation is sha224(opad + sha224(ipad + data)), where the
+    // padded key blocks have already been absorbed by the constructor
+    static_cast<void>(key);
+    SHA256_CTX ctx = m_hmac_inner;
+    SHA256_Update(&ctx, static_cast<const uint8_t*>(src), len);
+    SHA256_Final(dst, &ctx);
+
+    ctx = m_hmac_outer;
+    SHA256_Update(&ctx, dst, SHA224_DIGEST_LENGTH);
+    SHA256_Final(dst, &ctx);
 #else
     uint8_t ipad[64];
     for (size_t i = 0; i < 32; ++i)
@@ -400,7 +523,6 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     memset(opad + 32, 0x5C, 32);
 
     // Full hmac operation is sha224(opad + sha224(ipad + data))
-#ifdef _WIN32
     sha224_state s;
     sha_init(s);
     sha_process(s, ipad, 64);
@@ -411,19 +533,6 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     sha_process(s, opad, 64);
     sha_process(s, dst, 28); // 28 == SHA224_DIGEST_LENGTH
     sha_done(s, dst);
-#else
-    SHA256_CTX ctx;
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, ipad, 64);
-    SHA256_Update(&ctx, static_cast<const uint8_t*>(src), len);
-    SHA256_Final(dst, &ctx);
-
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, opad, 64);
-    SHA256_Update(&ctx, dst, SHA224_DIGEST_LENGTH);
-    SHA256_Final(dst, &ctx);
-#endif
-
 #endif
 }
 
@@ -498,23 +607,64 @@ bool EncryptedFileMapping::copy_up_to_date_page(size_t local_page_ndx) noexcept
     return false;
 }
 
-void EncryptedFileMapping::refresh_page(size_t local_page_ndx)
+void EncryptedFileMapping::mark_up_to_date(size_t local_page_ndx) noexcept
 {
-    REALM_ASSERT_EX(local_page_ndx < m_page_state.size(), local_page_ndx, m_page_state.size());
-
-    char* addr = page_addr(local_page_ndx);
-
-    if (!copy_up_to_date_page(local_page_ndx)) {
-        size_t page_ndx_in_file = local_page_ndx + m_first_page;
-        m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift),
-                            addr, static_cast<size_t>(1ULL << m_page_shift));
-    }
     if (is_not(m_page_state[local_page_ndx], UpToDate | PartiallyUpToDate))
         m_num_decrypted++;
     clear(m_page_state[local_page_ndx], PartiallyUpToDate);
     set(m_page_state[local_page_ndx], UpToDate);
 }
 
+void EncryptedFileMapping::refresh_pages(size_t begin_ndx, size_t end_ndx)
+{
+    REALM_ASSERT_EX(end_ndx <= m_page_state.size(), end_ndx, m_page_state.size());
+
+    size_t local_page_ndx = begin_ndx;
+    while (local_page_ndx < end_ndx) {
+        if (is(m_page_state[local_page_ndx], UpToDate)) {
+            ++local_page_ndx;
+            continue;
+        }
+        if (copy_up_to_date_page(local_page_ndx)) {
+            mark_up_to_date(local_page_ndx);
+            ++local_page_ndx;
+            continue;
+        }
+
+        // Pages which are not available from another mapping are decrypted
+        // in runs of consecutive pages, which allows the cryptor to read them
+        // from the file in batches.
+        size_t run_end = local_page_ndx + 1;
+        while (run_end < end_ndx && is_not(m_page_state[run_end], UpToDate)) {
+            if (copy_up_to_date_page(run_end)) {
+                mark_up_to_date(run_end);
+                break;
+            }
+            ++run_end;
+        }
+
+        size_t page_ndx_in_file = local_page_ndx + m_first_page;
+        m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(local_page_ndx),
+                            (run_end - local_page_ndx) << m_page_shift);
+        for (size_t ndx = local_page_ndx; ndx < run_end; ++ndx)
+            mark_up_to_date(ndx);
+        local_page_ndx = run_end;
+    }
+    m_last_refreshed_page = end_ndx - 1;
+}
+
+size_t EncryptedFileMapping::readahead_window(size_t local_page_ndx) noexcept
+{
+    // The window doubles with every sequential miss and collapses on a
+    // random access, so random lookups never decrypt more than they need.
+    bool sequential = m_last_refreshed_page != size_t(-1) && local_page_ndx == m_last_refreshed_page + 1;
+    if (sequential)
+        m_readahead_pages = std::min(std::max(m_readahead_pages * 2, size_t(4)), max_readahead_pages);
+    else
+        m_readahead_pages = 0;
+    return std::min(m_readahead_pages, m_page_state.size() - local_page_ndx - 1);
+}
+
 void EncryptedFileMapping::write_page(size_t local_page_ndx) noexcept
 {
     // Go through all other mappings of this file and mark
@@ -654,6 +804,7 @@ void EncryptedFileMapping::reclaim_untouched(size_t& progress_index, size_t& wor
                 clear(m_page_state[page_ndx], UpToDate | PartiallyUpToDate);
                 reclaim_page(page_ndx);
                 m_num_decrypted--;
+                m_file.num_reclaimed_pages.fetch_add(1, std::memory_order_relaxed);
                 done_some_work();
             }
             contiguous_scan = false;
@@ -719,10 +870,18 @@ void EncryptedFileMapping::flush() noexcept
             continue;
         }
 
+        // Write runs of consecutive dirty pages with a single call, so that
+        // the cryptor can batch them
+        size_t run_end = local_page_ndx + 1;
+        while (run_end < num_dirty_pages && is(m_page_state[run_end], Dirty))
+            ++run_end;
+
         size_t page_ndx_in_file = local_page_ndx + m_first_page;
         m_file.cryptor.write(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(local_page_ndx),
-                             static_cast<size_t>(1ULL << m_page_shift));
-        clear(m_page_state[local_page_ndx], Dirty);
+                             (run_end - local_page_ndx) << m_page_shift);
+        for (size_t ndx = local_page_ndx; ndx < run_end; ++ndx)
+            clear(m_page_state[ndx], Dirty);
+        local_page_ndx = run_end - 1;
     }
 
     validate();
@@ -797,8 +956,14 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to
         PageState& ps = m_page_state[first_accessed_local_page];
         if (is_not(ps, Touched))
             set(ps, Touched);
-        if (is_not(ps, UpToDate))
-            refresh_page(first_accessed_local_page);
+        if (is_not(ps, UpToDate)) {
+            m_file.num_page_misses.fetch_add(1, std::memory_order_relaxed);
+            size_t readahead = readahead_window(first_accessed_local_page);
+            refresh_pages(first_accessed_local_page, first_accessed_local_page + 1 + readahead);
+        }
+        else {
+            m_file.num_page_hits.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 
     // force the page reclaimer to look into pages in this chunk:
@@ -818,7 +983,9 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to
 
     // We already checked first_accessed_local_page above, so we start the loop
     // at first_accessed_local_page + 1 to check the following page.
-    for (size_t idx = first_accessed_local_page + 1; idx <= last_idx && idx < pages_size; ++idx) {
+    size_t end_idx = std::min(last_idx + 1, pages_size);
+    bool needs_refresh = false;
+    for (size_t idx = first_accessed_local_page + 1; idx < end_idx; ++idx) {
 
         // force the page reclaimer to look into pages in this chunk
         chunk_ndx = idx >> page_to_chunk_shift;
@@ -828,11 +995,51 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to
         PageState& ps = m_page_state[idx];
         if (is_not(ps, Touched))
             set(ps, Touched);
-        if (is_not(ps, UpToDate))
-            refresh_page(idx);
+        if (is_not(ps, UpToDate)) {
+            m_file.num_page_misses.fetch_add(1, std::memory_order_relaxed);
+            needs_refresh = true;
+        }
+        else {
+            m_file.num_page_hits.fetch_add(1, std::memory_order_relaxed);
+        }
     }
+    // Pages spanned by a large array are refreshed together so that they
+    // can be decrypted in batches
+    if (needs_refresh)
+        refresh_pages(first_accessed_local_page + 1, end_idx);
 }
 
+void EncryptedFileMapping::prefetch(const void* addr, size_t size, Header_to_size header_to_size)
+{
+    // The range is only a hint, so it is clipped to this mapping
+    if ((size == 0 && !header_to_size) || addr < m_addr)
+        return;
+    size_t offset = reinterpret_cast<uintptr_t>(addr) - reinterpret_cast<uintptr_t>(m_addr);
+    size_t first_ndx = offset >> m_page_shift;
+    if (first_ndx >= m_page_state.size())
+        return;
+
+    if (header_to_size) {
+        // Array headers are 8-byte aligned, so the header of the last array
+        // is within a single page. Once that page is decrypted, the size of
+        // the array tells how far the range extends.
+        size_t header_ndx = (offset + size) >> m_page_shift;
+        if (header_ndx < m_page_state.size()) {
+            refresh_pages(header_ndx, header_ndx + 1);
+            size += header_to_size(static_cast<const char*>(addr) + size);
+        }
+    }
+    if (size == 0)
+        return;
+    size_t last_ndx = std::min((offset + size - 1) >> m_page_shift, m_page_state.size() - 1);
+
+    for (size_t idx = first_ndx; idx <= last_ndx; ++idx) {
+        size_t chunk_ndx = idx >> page_to_chunk_shift;
+        if (m_chunk_dont_scan[chunk_ndx])
+            m_chunk_dont_scan[chunk_ndx] = 0;
+    }
+    refresh_pages(first_ndx, last_ndx + 1);
+}
 
 void EncryptedFileMapping::set(void* new_addr, size_t new_size, size_t new_file_offset)
 {
@@ -849,6 +1056,8 @@ void EncryptedFileMapping::set(void* new_addr, size_t new_size, size_t new_file_
     size_t num_pages = new_size >> m_page_shift;
 
     m_num_decrypted = 0;
+    m_last_refreshed_page = size_t(-1);
+    m_readahead_pages = 0;
     m_page_state.clear();
     m_chunk_dont_scan.clear();
 
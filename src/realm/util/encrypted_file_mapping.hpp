@@ -60,6 +60,13 @@ public:
     // becomes visible to any later calls to read_barrier()
     void write_barrier(const void* addr, size_t size) noexcept;
 
+    // Decrypt the pages in the specified range ahead of their use. Unlike
+    // read_barrier(), the pages are not marked as touched, so the page
+    // reclaimer may release them again if they end up not being used. If
+    // header_to_size is given, the range is extended to the end of the array
+    // whose header starts at addr + size.
+    void prefetch(const void* addr, size_t size, Header_to_size header_to_size = nullptr);
+
     // Set this mapping to a new address and size
     // Flushes any remaining dirty pages from the old mapping
     void set(void* new_addr, size_t new_size, size_t new_file_offset);
@@ -95,6 +102,13 @@ private:
     size_t m_first_page;
     size_t m_num_decrypted; // 1 for every page decrypted
 
+    // Readahead state. A read barrier which has to refresh the page right
+    // after the last page refreshed indicates a sequential scan, and causes
+    // a growing window of the following pages to be decrypted along with it.
+    static constexpr size_t max_readahead_pages = 32;
+    size_t m_last_refreshed_page = size_t(-1);
+    size_t m_readahead_pages = 0;
+
     enum PageState {
         Touched = 1,           // a ref->ptr translation has taken place
         UpToDate = 2,          // the page is fully up to date
@@ -134,7 +148,9 @@ private:
 
     void mark_outdated(size_t local_page_ndx) noexcept;
     bool copy_up_to_date_page(size_t local_page_ndx) noexcept;
-    void refresh_page(size_t local_page_ndx);
+    void mark_up_to_date(size_t local_page_ndx) noexcept;
+    void refresh_pages(size_t begin_ndx, size_t end_ndx);
+    size_t readahead_window(size_t local_page_ndx) noexcept;
     void write_page(size_t local_page_ndx) noexcept;
     void write_and_update_all(size_t local_page_ndx, size_t begin_offset, size_t end_offset) noexcept;
     void reclaim_page(size_t page_ndx);
@@ -1161,12 +1161,15 @@ void File::unlock() noexcept
 }
 
 
-void* File::map(AccessMode a, size_t size, int /*map_flags*/, size_t offset) const
+void* File::map(AccessMode a, size_t size, int map_flags, size_t offset) const
 {
-    return realm::util::mmap(m_fd, size, a, offset, m_encryption_key.get());
+    void* addr = realm::util::mmap(m_fd, size, a, offset, m_encryption_key.get());
+    if (!m_encryption_key)
+        realm::util::advise_map(addr, size, map_flags);
+    return addr;
 }
 
-void* File::map_fixed(AccessMode a, void* address, size_t size, int /* map_flags */, size_t offset) const
+void* File::map_fixed(AccessMode a, void* address, size_t size, int map_flags, size_t offset) const
 {
     if (m_encryption_key.get()) {
         // encryption enabled - this is not supported - see explanation in alloc_slab.cpp
@@ -1179,7 +1182,10 @@ void* File::map_fixed(AccessMode a, void* address, size_t size, int /* map_flags
     return nullptr;
 #else
     // unencrypted - mmap part of already reserved space
-    return realm::util::mmap_fixed(m_fd, address, size, a, offset, m_encryption_key.get());
+    void* addr = realm::util::mmap_fixed(m_fd, address, size, a, offset, m_encryption_key.get());
+    if (!m_encryption_key)
+        realm::util::advise_map(addr, size, map_flags);
+    return addr;
 #endif
 }
 
@@ -1190,12 +1196,15 @@ void* File::map_reserve(AccessMode a, size_t size, size_t offset) const
 }
 
 #if REALM_ENABLE_ENCRYPTION
-void* File::map(AccessMode a, size_t size, EncryptedFileMapping*& mapping, int /*map_flags*/, size_t offset) const
+void* File::map(AccessMode a, size_t size, EncryptedFileMapping*& mapping, int map_flags, size_t offset) const
 {
-    return realm::util::mmap(m_fd, size, a, offset, m_encryption_key.get(), mapping);
+    void* addr = realm::util::mmap(m_fd, size, a, offset, m_encryption_key.get(), mapping);
+    if (!m_encryption_key)
+        realm::util::advise_map(addr, size, map_flags);
+    return addr;
 }
 
-void* File::map_fixed(AccessMode a, void* address, size_t size, EncryptedFileMapping* mapping, int /* map_flags */,
+void* File::map_fixed(AccessMode a, void* address, size_t size, EncryptedFileMapping* mapping, int map_flags,
                       size_t offset) const
 {
     if (m_encryption_key.get()) {
@@ -1204,7 +1213,9 @@ void* File::map_fixed(AccessMode a, void* address, size_t size, EncryptedFileMap
     }
 #ifndef _WIN32
     // no encryption. On Unixes, map relevant part of reserved virtual address range
-    return realm::util::mmap_fixed(m_fd, address, size, a, offset, nullptr, mapping);
+    void* addr = realm::util::mmap_fixed(m_fd, address, size, a, offset, nullptr, mapping);
+    realm::util::advise_map(addr, size, map_flags);
+    return addr;
 #else
     // no encryption - unsupported on windows
     REALM_ASSERT(false);
@@ -1235,10 +1246,13 @@ void File::unmap(void* addr, size_t size) noexcept
 }
 
 
-void* File::remap(void* old_addr, size_t old_size, AccessMode a, size_t new_size, int /*map_flags*/,
+void* File::remap(void* old_addr, size_t old_size, AccessMode a, size_t new_size, int map_flags,
                   size_t file_offset) const
 {
-    return realm::util::mremap(m_fd, file_offset, old_addr, old_size, a, new_size, m_encryption_key.get());
+    void* addr = realm::util::mremap(m_fd, file_offset, old_addr, old_size, a, new_size, m_encryption_key.get());
+    if (!m_encryption_key)
+        realm::util::advise_remap(addr, old_size, new_size, map_flags);
+    return addr;
 }
 
 
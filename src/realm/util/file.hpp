@@ -379,7 +379,24 @@ public:
         /// the default behavior. An explicit call to sync_map() will
         /// flush the buffers regardless of whether this flag is
         /// specified or not.
-        map_NoSync = 1
+        map_NoSync = 1,
+
+        /// Fault in the entire mapping when it is established, to avoid
+        /// first touch page faults later on.
+        map_Populate = 2,
+
+        /// Ask for the mapping to be backed by transparent huge pages to
+        /// reduce TLB misses. Only effective if the kernel supports huge
+        /// pages for the file system holding the file.
+        map_HugePages = 4,
+
+        /// Expected access pattern, used by the kernel to tune readahead.
+        /// map_Sequential takes precedence if both are given.
+        map_Sequential = 8,
+        map_Random = 16,
+
+        /// Start reading the mapped range into memory in the background.
+        map_WillNeed = 32
     };
 
     /// Map this file into memory. The file is mapped as shared
@@ -402,6 +419,10 @@ public:
     ///
     /// Calling this function with a size that is greater than the
     /// size of the file has undefined behavior.
+    ///
+    /// All flags other than map_NoSync are hints which are applied with
+    /// advise_map(). They are ignored for encrypted files, whose pages are
+    /// decrypted into anonymous memory on demand.
     void* map(AccessMode, size_t size, int map_flags = 0, size_t offset = 0) const;
     void* map_fixed(AccessMode, void* address, size_t size, int map_flags = 0, size_t offset = 0) const;
     void* map_reserve(AccessMode, size_t size, size_t offset) const;
@@ -417,6 +438,9 @@ public:
     ///
     /// If this function throws, the old address range will remain
     /// mapped.
+    ///
+    /// The hints in \a map_flags are applied to the new range, except that
+    /// map_Populate only faults in the part beyond \a old_size.
     void* remap(void* old_addr, size_t old_size, AccessMode a, size_t new_size, int map_flags = 0,
                 size_t file_offset = 0) const;
 
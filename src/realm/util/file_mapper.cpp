@@ -33,6 +33,12 @@
 #include <realm/exceptions.hpp>
 #include <system_error>
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #if REALM_ENABLE_ENCRYPTION
 
 #include <realm/util/encrypted_file_mapping.hpp>
@@ -300,6 +306,28 @@ decrypted_memory_stats_t get_decrypted_memory_stats()
     return retval;
 }
 
+void set_decrypted_page_cache_budget(SharedFileInfo& info, size_t budget_in_bytes)
+{
+    UniqueLock lock(mapping_mutex);
+    // A non-zero budget is never rounded down to zero pages
+    info.decrypted_page_budget = (budget_in_bytes + page_size() - 1) / page_size();
+    if (info.decrypted_page_budget)
+        ensure_reclaimer_thread_runs();
+}
+
+decrypted_page_cache_stats_t get_decrypted_page_cache_stats(SharedFileInfo& info)
+{
+    // This is called on every transaction stage change when metrics are
+    // enabled, so it reads the counters without taking the mapping mutex.
+    decrypted_page_cache_stats_t retval;
+    retval.memory_size = info.num_decrypted_pages.load(std::memory_order_relaxed) * page_size();
+    retval.memory_budget = info.decrypted_page_budget.load(std::memory_order_relaxed) * page_size();
+    retval.hits = info.num_page_hits.load(std::memory_order_relaxed);
+    retval.misses = info.num_page_misses.load(std::memory_order_relaxed);
+    retval.evictions = info.num_reclaimed_pages.load(std::memory_order_relaxed);
+    return retval;
+}
+
 void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id)
 {
     UniqueLock lock(mapping_mutex);
@@ -316,6 +344,14 @@ void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id)
     ++info.current_version;
 }
 
+void encryption_prefetch(const void* addr, size_t size, EncryptedFileMapping* mapping, HeaderToSize header_to_size)
+{
+    if (mapping) {
+        UniqueLock lock(mapping_mutex);
+        mapping->prefetch(addr, size, header_to_size);
+    }
+}
+
 void encryption_note_reader_end(SharedFileInfo& info, const void* reader_id) noexcept
 {
     UniqueLock lock(mapping_mutex);
@@ -334,11 +370,12 @@ size_t collect_total_workload() // must be called under lock
     size_t total = 0;
     for (auto i = mappings_by_file.begin(); i != mappings_by_file.end(); ++i) {
         SharedFileInfo& info = *i->info;
-        info.num_decrypted_pages = 0;
+        size_t num_pages = 0;
         for (auto it = info.mappings.begin(); it != info.mappings.end(); ++it) {
-            info.num_decrypted_pages += (*it)->collect_decryption_count();
+            num_pages += (*it)->collect_decryption_count();
         }
-        total += info.num_decrypted_pages;
+        info.num_decrypted_pages.store(num_pages, std::memory_order_relaxed);
+        total += num_pages;
     }
     return total;
 }
@@ -413,6 +450,29 @@ void reclaim_pages_for_file(SharedFileInfo& info, size_t& work_limit)
     }
 }
 
+// Reclaim pages from the files which have a budget of their own and exceed it.
+// The work limit is at least the number of excess pages, so that a file is
+// brought back within its budget in a few rounds. Returns the number of pages
+// released, and keeps the per-file page counts up to date.
+size_t reclaim_pages_over_budget() // must be called under lock
+{
+    size_t total_reclaimed = 0;
+    for (auto& file : mappings_by_file) {
+        SharedFileInfo& info = *file.info;
+        size_t budget = info.decrypted_page_budget.load(std::memory_order_relaxed);
+        size_t num_pages = info.num_decrypted_pages.load(std::memory_order_relaxed);
+        if (budget == 0 || num_pages <= budget)
+            continue;
+        size_t work_limit = std::max(get_work_limit(num_pages, budget), num_pages - budget);
+        size_t reclaimed_before = info.num_reclaimed_pages.load(std::memory_order_relaxed);
+        reclaim_pages_for_file(info, work_limit);
+        size_t reclaimed = info.num_reclaimed_pages.load(std::memory_order_relaxed) - reclaimed_before;
+        info.num_decrypted_pages.store(num_pages - std::min(reclaimed, num_pages), std::memory_order_relaxed);
+        total_reclaimed += reclaimed;
+    }
+    return total_reclaimed;
+}
+
 // Reclaim pages from all files, limited by a work limit that is derived
 // from a target for the amount of dirty (decrypted) pages. The target is
 // set by the governor function.
@@ -423,6 +483,7 @@ void reclaim_pages()
     {
         UniqueLock lock(mapping_mutex);
         load = collect_total_workload();
+        load -= std::min(load, reclaim_pages_over_budget());
         num_decrypted_pages = load;
         runnable = governor->current_target_getter(load * page_size());
     }
@@ -922,6 +983,98 @@ void* mremap(FileDesc fd, size_t file_offset, void* old_addr, size_t old_size, F
     return new_addr;
 }
 
+void advise_map(void* addr, size_t size, int map_flags) noexcept
+{
+#ifndef _WIN32
+    if (map_flags & File::map_Sequential)
+        ::madvise(addr, size, MADV_SEQUENTIAL);
+    else if (map_flags & File::map_Random)
+        ::madvise(addr, size, MADV_RANDOM);
+#ifdef MADV_HUGEPAGE
+    if (map_flags & File::map_HugePages)
+        ::madvise(addr, size, MADV_HUGEPAGE);
+#endif
+    if (map_flags & File::map_WillNeed)
+        ::madvise(addr, size, MADV_WILLNEED);
+    if (map_flags & File::map_Populate) {
+#ifdef MADV_POPULATE_READ
+        if (::madvise(addr, size, MADV_POPULATE_READ) == 0)
+            return;
+#endif
+        // Older kernels: fault in the pages by touching each of them
+        const volatile char* p = static_cast<const char*>(addr);
+        for (size_t pos = 0; pos < size; pos += page_size())
+            static_cast<void>(p[pos]);
+    }
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    static_cast<void>(map_flags);
+#endif
+}
+
+void advise_remap(void* addr, size_t old_size, size_t new_size, int map_flags) noexcept
+{
+    advise_map(addr, new_size, map_flags & ~File::map_Populate);
+    if ((map_flags & File::map_Populate) && new_size > old_size) {
+        size_t populated = old_size & ~(page_size() - 1);
+        advise_map(static_cast<char*>(addr) + populated, new_size - populated, File::map_Populate);
+    }
+}
+
+mapping_stats_t get_mapping_stats(const void* addr, size_t size)
+{
+    mapping_stats_t stats;
+#ifndef _WIN32
+    auto begin = reinterpret_cast<uintptr_t>(addr) & ~uintptr_t(page_size() - 1);
+    auto end = reinterpret_cast<uintptr_t>(addr) + size;
+    size_t num_pages = (end - begin + page_size() - 1) / page_size();
+#if REALM_PLATFORM_APPLE
+    std::vector<char> residency(num_pages);
+#else
+    std::vector<unsigned char> residency(num_pages);
+#endif
+    if (::mincore(reinterpret_cast<void*>(begin), end - begin, residency.data()) == 0) {
+        for (auto page : residency) {
+            if (page & 1)
+                stats.resident_size += page_size();
+        }
+    }
+    stats.resident_size = std::min(stats.resident_size, size);
+
+#if defined(__linux__)
+    // Each area in smaps starts with a line holding its address range. The
+    // huge page counters of all areas overlapping the range are summed up.
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool overlaps = false;
+    while (std::getline(smaps, line)) {
+        unsigned long long area_begin, area_end;
+        char dash;
+        std::istringstream in(line);
+        if (in >> std::hex >> area_begin >> dash >> area_end && dash == '-') {
+            overlaps = area_begin < end && begin < area_end;
+            continue;
+        }
+        if (!overlaps)
+            continue;
+        if (line.compare(0, 14, "AnonHugePages:") == 0 || line.compare(0, 14, "FilePmdMapped:") == 0 ||
+            line.compare(0, 15, "ShmemPmdMapped:") == 0) {
+            size_t kb = 0;
+            std::istringstream value(line.substr(line.find(':') + 1));
+            value >> kb;
+            stats.huge_page_size += kb * 1024;
+        }
+    }
+    stats.huge_page_size = std::min(stats.huge_page_size, size);
+#endif
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+#endif
+    return stats;
+}
+
 void msync(FileDesc fd, void* addr, size_t size)
 {
 #if REALM_ENABLE_ENCRYPTION
@@ -39,6 +39,31 @@ void* mremap(FileDesc fd, size_t file_offset, void* old_addr, size_t old_size, F
 void msync(FileDesc fd, void* addr, size_t size);
 void* mmap_anon(size_t size);
 
+// Apply the hints given by a combination of the File::map_* flags to a range
+// returned by mmap(). Every hint is best effort, hints which are not supported
+// by the platform are ignored. The range must not extend beyond the end of
+// the file if File::map_Populate is given.
+void advise_map(void* addr, size_t size, int map_flags) noexcept;
+
+// The same as advise_map() for a range which replaces a mapping of the first
+// \a old_size bytes of the same part of the file. File::map_Populate is only
+// applied from the page holding offset \a old_size and onwards, as the pages in
+// front of it were populated when they were first mapped.
+void advise_remap(void* addr, size_t old_size, size_t new_size, int map_flags) noexcept;
+
+// Retrieves the
+// - amount of memory in the range which is resident, i.e. which can be accessed
+//   without a major page fault
+// - amount of memory in the range which is backed by huge pages. The kernel
+//   reports this per virtual memory area, so it is approximate if the range
+//   shares an area with adjacent mappings.
+struct mapping_stats_t {
+    size_t resident_size = 0;
+    size_t huge_page_size = 0;
+};
+
+mapping_stats_t get_mapping_stats(const void* addr, size_t size);
+
 // A function which may be given to encryption_read_barrier. If present, the read barrier is a
 // a barrier for a full array. If absent, the read barrier is a barrier only for the address
 // range give as argument. If the barrier is for a full array, it will read the array header
@@ -88,6 +113,21 @@ struct decrypted_memory_stats_t {
 
 decrypted_memory_stats_t get_decrypted_memory_stats();
 
+// Retrieves the page cache statistics for a single file:
+// - amount of memory used for decrypted pages of the file, as of the last
+//   round of the page reclaimer
+// - the memory budget of the file (0 if only the global target applies)
+// - number of page accesses served by pages which were already decrypted
+// - number of page accesses which required the page to be decrypted
+// - number of decrypted pages released again by the page reclaimer
+struct decrypted_page_cache_stats_t {
+    size_t memory_size = 0;
+    size_t memory_budget = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
 #if REALM_ENABLE_ENCRYPTION
 
 void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id);
@@ -95,6 +135,15 @@ void encryption_note_reader_end(SharedFileInfo& info, const void* reader_id) noe
 
 SharedFileInfo* get_file_info_for_file(File& file);
 
+// Limit the amount of memory used for decrypted pages of a single file. The
+// page reclaimer releases the least recently touched pages of the file once it
+// exceeds the budget, independently of the global target set by the governor.
+// Pages are only released once no reader older than the last complete scan of
+// the file remains. A budget of 0 removes the limit.
+void set_decrypted_page_cache_budget(SharedFileInfo& info, size_t budget_in_bytes);
+
+decrypted_page_cache_stats_t get_decrypted_page_cache_stats(SharedFileInfo& info);
+
 // This variant allows the caller to obtain direct access to the encrypted file mapping
 // for optimization purposes.
 void* mmap(FileDesc fd, size_t size, File::AccessMode access, size_t offset, const char* encryption_key,
@@ -123,6 +172,13 @@ void inline encryption_write_barrier(const void* addr, size_t size, EncryptedFil
         do_encryption_write_barrier(addr, size, mapping);
 }
 
+// Decrypt the pages covering the specified range ahead of their use, e.g.
+// before scanning a range of the file. This is only a hint and does not
+// replace the read barrier. If header_to_size is given, the range is extended
+// to the end of the array whose header starts at addr + size.
+void encryption_prefetch(const void* addr, size_t size, EncryptedFileMapping* mapping,
+                         HeaderToSize header_to_size = nullptr);
+
 
 extern util::Mutex& mapping_mutex;
 
@@ -162,6 +218,10 @@ void inline encryption_write_barrier(const void*, size_t, EncryptedFileMapping*)
 {
 }
 
+void inline encryption_prefetch(const void*, size_t, EncryptedFileMapping*, HeaderToSize = nullptr)
+{
+}
+
 #endif
 
 // helpers for encrypted Maps
@@ -19,16 +19,22 @@
 #include "testsettings.hpp"
 #ifdef TEST_ALLOC
 
+#include <algorithm>
 #include <string>
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <set>
 #include <vector>
 
 #include <realm/util/file.hpp>
 #include <realm/alloc_slab.hpp>
 #include <realm/util/allocator.hpp>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include "test.hpp"
 
 using namespace realm;
@@ -314,6 +320,168 @@ TEST(Alloc_Fuzzy)
     }
 }
 
+TEST(Alloc_SlabStats)
+{
+    SlabAlloc alloc;
+    alloc.attach_empty();
+    CHECK_EQUAL(alloc.get_slab_stats().used_size, 0);
+
+    // The first allocation creates a slab, the following ones are cut from its tail
+    std::vector<MemRef> refs;
+    for (size_t i = 0; i < 100; ++i) {
+        MemRef r = alloc.alloc(64);
+        set_capacity(r.get_addr(), 64);
+        refs.push_back(r);
+    }
+    auto stats = alloc.get_slab_stats();
+    CHECK_EQUAL(stats.used_size, 6400);
+    CHECK_EQUAL(stats.peak_used_size, 6400);
+    CHECK_GREATER_EQUAL(stats.slab_size, 6400);
+    CHECK_EQUAL(stats.free_list_allocations, 1);
+    CHECK_EQUAL(stats.bump_allocations, 99);
+    CHECK_EQUAL(stats.size_class_allocations, 0);
+
+    // Freed small blocks are reused for allocations of the same size
+    std::set<ref_type> freed;
+    for (size_t i = 0; i < refs.size(); i += 2) {
+        freed.insert(refs[i].get_ref());
+        alloc.free_(refs[i].get_ref(), refs[i].get_addr());
+    }
+    alloc.verify();
+    for (size_t i = 0; i < refs.size(); i += 2) {
+        MemRef r = alloc.alloc(64);
+        CHECK_EQUAL(freed.count(r.get_ref()), 1);
+        set_capacity(r.get_addr(), 64);
+        refs[i] = r;
+    }
+    stats = alloc.get_slab_stats();
+    CHECK_EQUAL(stats.size_class_allocations, 50);
+    CHECK_EQUAL(stats.free_list_allocations, 1);
+
+    // A large block freed next to the tail is merged back into it
+    MemRef big = alloc.alloc(4096);
+    set_capacity(big.get_addr(), 4096);
+    alloc.free_(big.get_ref(), big.get_addr());
+    MemRef r = alloc.alloc(4096);
+    CHECK_EQUAL(r.get_ref(), big.get_ref());
+    set_capacity(r.get_addr(), 4096);
+    refs.push_back(r);
+    CHECK_EQUAL(alloc.get_slab_stats().bump_allocations, 101);
+
+    for (auto& ref : refs)
+        alloc.free_(ref.get_ref(), ref.get_addr());
+    stats = alloc.get_slab_stats();
+    CHECK_EQUAL(stats.used_size, 0);
+    CHECK_EQUAL(stats.peak_used_size, 6400 + 4096);
+#ifdef REALM_DEBUG
+    CHECK(alloc.is_all_free());
+#endif
+    alloc.verify();
+}
+
+TEST(Alloc_GrowingBlocksReuseFreedSpace)
+{
+    SlabAlloc alloc;
+    alloc.attach_empty();
+
+    // Like an array growing under copy-on-write, every allocation is larger
+    // than the block freed just before it, so no size is ever requested
+    // again. The freed blocks must still be reused once the tail is used up.
+    size_t total = 0;
+    MemRef prev;
+    for (size_t i = 0; i < 20000; ++i) {
+        size_t size = 16 + 8 * (i % 120);
+        MemRef r = alloc.alloc(size);
+        set_capacity(r.get_addr(), size);
+        total += size;
+        if (prev.get_addr())
+            alloc.free_(prev.get_ref(), prev.get_addr());
+        prev = r;
+    }
+    alloc.verify();
+    auto stats = alloc.get_slab_stats();
+    CHECK_GREATER(total, 8 * 1024 * 1024);
+    CHECK_LESS(stats.slab_size, 1024 * 1024);
+    alloc.free_(prev.get_ref(), prev.get_addr());
+    CHECK_EQUAL(alloc.get_slab_stats().used_size, 0);
+}
+
+TEST(Alloc_WriteMemoryLimit)
+{
+    TEST_DIR(dir);
+    SlabAlloc alloc;
+    alloc.attach_empty();
+    alloc.set_write_memory_limit(256 * 1024, dir);
+
+    const size_t block_size = 32 * 1024;
+    std::vector<MemRef> refs;
+    for (size_t i = 0; i < 64; ++i) {
+        MemRef r = alloc.alloc(block_size);
+        set_capacity(r.get_addr(), block_size);
+        std::fill(r.get_addr() + 8, r.get_addr() + block_size, char(i));
+        refs.push_back(r);
+    }
+    auto stats = alloc.get_slab_stats();
+    CHECK_GREATER(stats.spilled_size, 0);
+    CHECK_LESS_EQUAL(stats.slab_size - stats.spilled_size, 256 * 1024);
+
+    for (size_t i = 0; i < refs.size(); ++i) {
+        const char* addr = alloc.translate(refs[i].get_ref());
+        CHECK_EQUAL(addr, refs[i].get_addr());
+        CHECK(std::all_of(addr + 8, addr + block_size, [&](char c) {
+            return c == char(i);
+        }));
+    }
+
+    for (auto& ref : refs)
+        alloc.free_(ref.get_ref(), ref.get_addr());
+    alloc.reset_free_space_tracking();
+    stats = alloc.get_slab_stats();
+    CHECK_EQUAL(stats.spilled_size, 0);
+    CHECK_LESS_EQUAL(stats.slab_size, 256 * 1024);
+}
+
+#ifndef _WIN32
+// Changes the working directory, so it cannot run concurrently with other tests
+NONCONCURRENT_TEST(Alloc_WriteMemoryLimitWithoutSpillDir)
+{
+    GROUP_TEST_PATH(path);
+    TEST_DIR(dir);
+    char cwd[4096];
+    CHECK(getcwd(cwd, sizeof cwd));
+    std::string abs_path = std::string(cwd) + "/" + std::string(path);
+
+    SlabAlloc alloc;
+    SlabAlloc::Config cfg;
+    alloc.attach_file(abs_path, cfg);
+    alloc.reset_free_space_tracking();
+    alloc.set_write_memory_limit(64 * 1024, "");
+
+    // Without a spill directory, the spill file must be created next to the
+    // Realm file and not in the working directory, which here no longer exists
+    std::string gone = std::string(cwd) + "/" + std::string(dir) + "/gone";
+    util::make_dir(gone);
+    CHECK_EQUAL(chdir(gone.c_str()), 0);
+    util::remove_dir(gone);
+    std::vector<MemRef> refs;
+    try {
+        for (size_t i = 0; i < 16; ++i) {
+            MemRef r = alloc.alloc(32 * 1024);
+            set_capacity(r.get_addr(), 32 * 1024);
+            refs.push_back(r);
+        }
+    }
+    catch (...) {
+        CHECK(false);
+    }
+    CHECK_EQUAL(chdir(cwd), 0);
+    CHECK_GREATER(alloc.get_slab_stats().spilled_size, 0);
+
+    for (auto& ref : refs)
+        alloc.free_(ref.get_ref(), ref.get_addr());
+}
+#endif
+
 namespace {
 
 class TestSlabAlloc : public SlabAlloc
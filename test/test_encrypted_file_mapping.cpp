@@ -31,6 +31,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <vector>
+
 // Test independence and thread-safety
 // -----------------------------------
 //
@@ -184,5 +186,63 @@ TEST(EncryptedFile_LargePages)
     close(fd);
 }
 
+TEST(EncryptedFile_BatchedReadWrite)
+{
+    TEST_PATH(path);
+
+    // Spans several metadata blocks (one for every 64 data blocks) so that
+    // batches have to be split
+    const size_t num_blocks = 150;
+    std::vector<char> data(4096 * num_blocks);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i * 7 + i / 4096);
+
+    AESCryptor cryptor(test_key);
+    cryptor.set_file_size(off_t(data.size()));
+    std::vector<char> buffer(data.size());
+
+    int fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    cryptor.write(fd, 0, data.data(), data.size());
+    CHECK(cryptor.read(fd, 0, buffer.data(), buffer.size()));
+    CHECK(buffer == data);
+
+    // Rewrite a range crossing a metadata block boundary and read back
+    // through a fresh cryptor, which has to load the IV tables from the file
+    for (size_t i = 4096 * 60; i < 4096 * 70; ++i)
+        data[i] = static_cast<char>(~data[i]);
+    cryptor.write(fd, 4096 * 60, data.data() + 4096 * 60, 4096 * 10);
+    {
+        AESCryptor cryptor_2(test_key);
+        cryptor_2.set_file_size(off_t(data.size()));
+        CHECK(cryptor_2.read(fd, 4096 * 10, buffer.data(), 4096 * 100));
+        CHECK(memcmp(buffer.data(), data.data() + 4096 * 10, 4096 * 100) == 0);
+    }
+    close(fd);
+}
+
+TEST(EncryptedFile_BatchedReadUnwrittenBlocks)
+{
+    TEST_PATH(path);
+
+    char data[4096 * 4];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = static_cast<char>(i);
+
+    AESCryptor cryptor(test_key);
+    cryptor.set_file_size(sizeof(data));
+    int fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    // Leave the second block unwritten
+    cryptor.write(fd, 0, data, 4096);
+    cryptor.write(fd, 4096 * 2, data + 4096 * 2, 4096 * 2);
+
+    // The unwritten block is reported, but the blocks after it must still be
+    // decrypted
+    char buffer[sizeof(data)];
+    CHECK_NOT(cryptor.read(fd, 0, buffer, sizeof(buffer)));
+    CHECK(memcmp(buffer, data, 4096) == 0);
+    CHECK(memcmp(buffer + 4096 * 2, data + 4096 * 2, 4096 * 2) == 0);
+    close(fd);
+}
+
 #endif // REALM_ENABLE_ENCRYPTION
 #endif // TEST_ENCRYPTED_FILE_MAPPING
@@ -24,6 +24,7 @@
 
 #include <realm/util/file.hpp>
 #include <realm/util/file_mapper.hpp>
+#include <realm/util/encrypted_file_mapping.hpp>
 
 #include "test.hpp"
 
@@ -178,6 +179,43 @@ TEST(File_MapMultiplePages)
     }
 }
 
+TEST(File_MapFlags)
+{
+    TEST_PATH(path);
+    const size_t size = 16 * page_size();
+    File f(path, File::mode_Write);
+    f.resize(size);
+    {
+        File::Map<char> map(f, File::access_ReadWrite, size);
+        for (size_t i = 0; i < size; ++i)
+            map.get_addr()[i] = char(i % 251);
+        map.sync();
+    }
+
+    // The hints must not change what is read through the mapping
+    int flags = File::map_Populate | File::map_Random | File::map_HugePages | File::map_WillNeed;
+    File::Map<char> map(f, File::access_ReadOnly, size, flags);
+    for (size_t i = 0; i < size; i += 997)
+        CHECK_EQUAL(map.get_addr()[i], char(i % 251));
+
+    auto stats = get_mapping_stats(map.get_addr(), size);
+#ifndef _WIN32
+    // Everything has been faulted in by map_Populate
+    CHECK_EQUAL(stats.resident_size, size);
+#endif
+    CHECK_LESS_EQUAL(stats.huge_page_size, size);
+
+    // Growing a mapping with remap() populates the new part as well
+    void* addr = f.map(File::access_ReadOnly, size / 2, flags);
+    addr = f.remap(addr, size / 2, File::access_ReadOnly, size, flags);
+    CHECK_EQUAL(static_cast<const char*>(addr)[size - 1], char((size - 1) % 251));
+#ifndef _WIN32
+    CHECK_EQUAL(get_mapping_stats(addr, size).resident_size, size);
+#endif
+    f.unmap(addr, size);
+}
+
+
 TEST(File_ReaderAndWriter)
 {
     const size_t count = 4096 / sizeof(size_t) * 256 * 2;
@@ -206,6 +244,93 @@ TEST(File_ReaderAndWriter)
     }
 }
 
+TEST(File_SequentialReadAhead)
+{
+    const size_t count_per_page = page_size() / sizeof(size_t);
+    const size_t page_count = 200;
+    const size_t count = count_per_page * page_count;
+
+    TEST_PATH(path);
+    File writer(path, File::mode_Write);
+    writer.set_encryption_key(crypt_key(true));
+    writer.resize(count * sizeof(size_t));
+    File::Map<size_t> write(writer, File::access_ReadWrite, count * sizeof(size_t));
+    realm::util::encryption_read_barrier(write, 0, count);
+    for (size_t i = 0; i < count; ++i)
+        write.get_addr()[i] = i;
+    realm::util::encryption_write_barrier(write, 0, count);
+    write.sync();
+
+    File reader(path, File::mode_Read);
+    reader.set_encryption_key(crypt_key(true));
+    File::Map<size_t> read(reader, File::access_ReadOnly, count * sizeof(size_t));
+
+    // A sequential scan touching one element per page triggers readahead
+    for (size_t page = 0; page < page_count / 2; ++page) {
+        size_t i = page * count_per_page + 7;
+        realm::util::encryption_read_barrier(read, i);
+        CHECK_EQUAL(read.get_addr()[i], i);
+    }
+
+    // Pages decrypted ahead of time by the reader must see later changes
+    size_t changed = (page_count / 2 + 1) * count_per_page + 3;
+    realm::util::encryption_read_barrier(write, changed);
+    write.get_addr()[changed] = 42;
+    realm::util::encryption_write_barrier(write, changed);
+    realm::util::encryption_read_barrier(read, changed);
+    CHECK_EQUAL(read.get_addr()[changed], 42);
+
+    // Explicit prefetch of the remaining pages
+    size_t rest = page_count / 2 * count_per_page;
+    realm::util::encryption_prefetch(read.get_addr() + rest, (count - rest) * sizeof(size_t),
+                                     read.get_encrypted_mapping());
+    for (size_t i = rest; i < count; i += 13) {
+        realm::util::encryption_read_barrier(read, i);
+        CHECK_EQUAL(read.get_addr()[i], i == changed ? 42 : i);
+    }
+}
+
+#if REALM_ENABLE_ENCRYPTION
+TEST(File_PrefetchThroughLastArray)
+{
+    const size_t count_per_page = page_size() / sizeof(size_t);
+    const size_t page_count = 8;
+    const size_t count = count_per_page * page_count;
+
+    TEST_PATH(path);
+    {
+        File writer(path, File::mode_Write);
+        writer.set_encryption_key(crypt_key(true));
+        writer.resize(count * sizeof(size_t));
+        File::Map<size_t> write(writer, File::access_ReadWrite, count * sizeof(size_t));
+        realm::util::encryption_read_barrier(write, 0, count);
+        for (size_t i = 0; i < count; ++i)
+            write.get_addr()[i] = i;
+        realm::util::encryption_write_barrier(write, 0, count);
+        write.sync();
+    }
+
+    File reader(path, File::mode_Read);
+    reader.set_encryption_key(crypt_key(true));
+    File::Map<size_t> read(reader, File::access_ReadOnly, count * sizeof(size_t));
+    auto mapping = read.get_encrypted_mapping();
+    size_t decrypted = mapping->collect_decryption_count();
+
+    // The range ends at the header of an array spanning three pages, which
+    // are decrypted along with the two pages before it
+    auto three_pages = [](const char*) {
+        return 3 * page_size();
+    };
+    realm::util::encryption_prefetch(read.get_addr(), 2 * page_size(), mapping, three_pages);
+    CHECK_EQUAL(mapping->collect_decryption_count() - decrypted, 5);
+    for (size_t i = 0; i < 5 * count_per_page; i += 13) {
+        realm::util::encryption_read_barrier(read, i);
+        CHECK_EQUAL(read.get_addr()[i], i);
+    }
+    CHECK_EQUAL(mapping->collect_decryption_count() - decrypted, 5);
+}
+#endif // REALM_ENABLE_ENCRYPTION
+
 TEST(File_Offset)
 {
     const size_t size = page_size();
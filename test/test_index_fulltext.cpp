@@ -0,0 +1,440 @@
+/*************************************************************************
+ *
+ * Copyright 2020 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_INDEX_FULLTEXT
+
+#include <realm.hpp>
+#include <realm/history.hpp>
+#include <realm/index_fulltext.hpp>
+#include "test.hpp"
+#include "util/check_logic_error.hpp"
+#include "util/random.hpp"
+
+using namespace realm;
+using namespace realm::util;
+using namespace realm::test_util;
+using unit_test::TestContext;
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+
+namespace {
+
+using Words = std::vector<std::string>;
+
+// Checks that every query gives the same result on the indexed column `col`
+// and on the column `plain` holding the same values without an index.
+void check_same_results(TestContext& test_context, Table& table, ColKey col, ColKey plain, StringData needle)
+{
+    CHECK_EQUAL(table.where().contains(col, needle).count(), table.where().contains(plain, needle).count());
+    CHECK_EQUAL(table.where().contains(col, needle, false).count(),
+                table.where().contains(plain, needle, false).count());
+    CHECK_EQUAL(table.where().fulltext(col, needle).count(), table.where().fulltext(plain, needle).count());
+    CHECK_EQUAL(table.where().not_equal(col, "").fulltext(col, needle).count(),
+                table.where().not_equal(plain, "").fulltext(plain, needle).count());
+}
+
+} // anonymous namespace
+
+
+TEST(FullTextIndex_Tokenize)
+{
+    CHECK(FullTextIndex::tokenize(StringData()).empty());
+    CHECK(FullTextIndex::tokenize("").empty());
+    CHECK(FullTextIndex::tokenize(" ,.- ").empty());
+    CHECK(FullTextIndex::tokenize("The quick, brown fox - the QUICK one!") ==
+          Words({"brown", "fox", "one", "quick", "the"}));
+    CHECK(FullTextIndex::tokenize("abc123 x_y") == Words({"abc123", "x", "y"}));
+    // Non ASCII characters are part of words and are not folded
+    CHECK(FullTextIndex::tokenize("Æble grød") == Words({"grød", "Æble"}));
+
+    CHECK(FullTextIndex::enclosed_words("quick").empty());
+    CHECK(FullTextIndex::enclosed_words("quick brown").empty());
+    CHECK(FullTextIndex::enclosed_words("ick brown fo") == Words({"brown"}));
+    CHECK(FullTextIndex::enclosed_words(" Quick ") == Words({"quick"}));
+
+    CHECK(FullTextIndex::contains_words("The quick fox", {"fox", "the"}));
+    CHECK(FullTextIndex::contains_words("The quick fox", {}));
+    CHECK_NOT(FullTextIndex::contains_words("The quick fox", {"fo"}));
+    CHECK_NOT(FullTextIndex::contains_words(StringData(), {"fox"}));
+}
+
+TEST(FullTextIndex_Maintenance)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    auto col = table.add_column(type_String, "text", true);
+
+    Obj o0 = table.create_object().set(col, "red green");
+    Obj o1 = table.create_object().set(col, "green blue");
+    table.create_object();
+
+    table.add_fulltext_index(col);
+    CHECK(table.has_fulltext_index(col));
+    CHECK_NOT(table.has_search_index(col));
+    // Adding it twice is a no-op
+    table.add_fulltext_index(col);
+
+    FullTextIndex* index = table.get_fulltext_index(col);
+    CHECK(index);
+    index->verify();
+    CHECK_EQUAL(index->num_words(), 3);
+    CHECK_EQUAL(index->count("green"), 2);
+    CHECK_EQUAL(index->count("red"), 1);
+    CHECK_EQUAL(index->count("Red"), 0);
+
+    std::vector<ObjKey> keys;
+    index->find_all(keys, {"green"});
+    CHECK(keys == std::vector<ObjKey>({o0.get_key(), o1.get_key()}));
+    index->find_all(keys, {"blue", "green"});
+    CHECK(keys == std::vector<ObjKey>({o1.get_key()}));
+    index->find_all(keys, {"blue", "red"});
+    CHECK(keys.empty());
+    index->find_all(keys, {});
+    CHECK(keys.empty());
+
+    // Words shared between the old and the new value are kept
+    o0.set(col, "Green yellow green");
+    index->verify();
+    CHECK_EQUAL(index->count("red"), 0);
+    CHECK_EQUAL(index->count("green"), 2);
+    CHECK_EQUAL(index->count("yellow"), 1);
+
+    Obj o3 = table.create_object().set(col, "blue");
+    CHECK_EQUAL(index->count("blue"), 2);
+    o1.set_null(col);
+    index->verify();
+    CHECK_EQUAL(index->count("blue"), 1);
+    CHECK_EQUAL(index->count("green"), 1);
+
+    o3.remove();
+    index->verify();
+    CHECK_EQUAL(index->count("blue"), 0);
+    CHECK_EQUAL(index->num_words(), 2);
+
+    // Objects created with a non-default value
+    Obj o4 = table.create_object(ObjKey(100), {{col, "purple"}});
+    CHECK_EQUAL(index->count("purple"), 1);
+    // Keys inserted out of order
+    table.create_object(ObjKey(50)).set(col, "purple");
+    index->verify();
+    index->find_all(keys, {"purple"});
+    CHECK(keys == std::vector<ObjKey>({ObjKey(50), o4.get_key()}));
+
+    table.clear();
+    index->verify();
+    CHECK(index->is_empty());
+
+    table.create_object().set(col, "after clear");
+    CHECK_EQUAL(index->count("clear"), 1);
+
+    table.remove_fulltext_index(col);
+    CHECK_NOT(table.has_fulltext_index(col));
+    CHECK_NOT(table.get_fulltext_index(col));
+    CHECK_EQUAL(table.where().fulltext(col, "clear").count(), 1);
+}
+
+TEST(FullTextIndex_Query)
+{
+    Table table;
+    auto col = table.add_column(type_String, "indexed");
+    auto plain = table.add_column(type_String, "plain");
+
+    const char* values[] = {"The cat sat on the mat",
+                            "Concatenate the strings",
+                            "A CAT and a dog",
+                            "dog eat dog",
+                            "cat",
+                            "",
+                            "the cat-dog",
+                            "Scatter the cat food on the floor"};
+    for (auto value : values) {
+        table.create_object().set(col, value).set(plain, value);
+    }
+    table.add_fulltext_index(col);
+
+    // All the words must be present, in any order and case
+    CHECK_EQUAL(table.where().fulltext(col, "cat").count(), 5);
+    CHECK_EQUAL(table.where().fulltext(col, "DOG cat").count(), 2);
+    CHECK_EQUAL(table.where().fulltext(col, "cat the").count(), 3);
+    CHECK_EQUAL(table.where().fulltext(col, "mouse").count(), 0);
+    CHECK_EQUAL(table.where().fulltext(col, "").count(), 8);
+    CHECK_EQUAL(table.where().fulltext(col, "cat").Not().fulltext(col, "dog").count(), 3);
+    CHECK_EQUAL(table.where().fulltext(col, "dog").find(), table.get_object(2).get_key());
+
+    // Substrings, including ones where the words at the ends of the needle
+    // are only part of a longer word
+    for (auto needle : {"cat", " cat ", "at ", " the ", "oncat", "e cat s", "t the cat f", "a dog", " CAT a",
+                        "e the s", "-", "dog ", "mouse", " mouse ", "the cat-dog", ""}) {
+        check_same_results(test_context, table, col, plain, needle);
+    }
+    CHECK_EQUAL(table.where().contains(col, " the ").count(), 3);
+    CHECK_EQUAL(table.where().contains(col, " CAT ", false).count(), 3);
+    CHECK_EQUAL(table.where().contains(col, " CAT ").count(), 1);
+
+    // Result of a query on an indexed column used in a TableView
+    TableView tv = table.where().fulltext(col, "cat").find_all();
+    CHECK_EQUAL(tv.size(), 5);
+    table.get_object(4).set(col, "kitten");
+    tv.sync_if_needed();
+    CHECK_EQUAL(tv.size(), 4);
+
+    CHECK_THROW(table.where().fulltext(table.add_column(type_Int, "int"), "cat"), LogicError);
+}
+
+TEST(FullTextIndex_Random)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const char* vocabulary[] = {"alpha", "Beta", "gamma", "delta", "al", "pha", "ALPHA", "gam"};
+    const char* separators[] = {" ", ", ", "-", "\n"};
+
+    auto random_value = [&] {
+        std::string value;
+        size_t num_words = random.draw_int_max(4);
+        for (size_t i = 0; i < num_words; ++i) {
+            if (i > 0 || random.draw_bool())
+                value += separators[random.draw_int_max(3)];
+            value += vocabulary[random.draw_int_max(7)];
+        }
+        return value;
+    };
+
+    Table table;
+    auto col = table.add_column(type_String, "indexed", true);
+    auto plain = table.add_column(type_String, "plain", true);
+    table.add_fulltext_index(col);
+    FullTextIndex* index = table.get_fulltext_index(col);
+
+    for (size_t round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < 200; ++i) {
+            size_t action = random.draw_int_max(9);
+            if (action < 4 || table.size() == 0) {
+                std::string str = random_value();
+                StringData value(str);
+                ObjKey key(random.draw_int_max(10000));
+                if (!table.is_valid(key))
+                    table.create_object(key).set(col, value).set(plain, value);
+            }
+            else if (action < 8) {
+                Obj obj = table.get_object(random.draw_int_max(table.size() - 1));
+                if (action == 7) {
+                    obj.set_null(col);
+                    obj.set_null(plain);
+                }
+                else {
+                    std::string str = random_value();
+                    StringData value(str);
+                    obj.set(col, value).set(plain, value);
+                }
+            }
+            else {
+                table.get_object(random.draw_int_max(table.size() - 1)).remove();
+            }
+        }
+        index->verify();
+
+        for (auto needle : {"alpha", "alpha gam", " al ", "a, gamma-", "beta alpha delta", " pha\n", "a Beta "}) {
+            check_same_results(test_context, table, col, plain, needle);
+        }
+    }
+}
+
+TEST(FullTextIndex_IllegalCombinations)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_str = table.add_column(type_String, "str");
+    auto col_indexed = table.add_column(type_String, "indexed");
+    auto col_list = table.add_column_list(type_String, "list");
+    table.add_search_index(col_indexed);
+
+    CHECK_LOGIC_ERROR(table.add_fulltext_index(col_int), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table.add_fulltext_index(col_list), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table.add_fulltext_index(col_indexed), LogicError::illegal_combination);
+    CHECK_THROW(table.add_fulltext_index(ColKey()), ColumnNotFound);
+
+    table.add_fulltext_index(col_str);
+    CHECK_LOGIC_ERROR(table.add_search_index(col_str), LogicError::illegal_combination);
+    CHECK_NOT(table.has_search_index(col_str));
+
+    // Making the column the primary key drops the full-text index
+    table.set_primary_key_column(col_str);
+    CHECK_NOT(table.has_fulltext_index(col_str));
+    CHECK_LOGIC_ERROR(table.add_fulltext_index(col_str), LogicError::illegal_combination);
+}
+
+TEST(FullTextIndex_ColumnChanges)
+{
+    Table table;
+    auto col_a = table.add_column(type_String, "a");
+    auto col_b = table.add_column(type_String, "b");
+    auto col_c = table.add_column(type_String, "c");
+    for (auto value : {"one two", "two three", "three four"}) {
+        table.create_object().set(col_a, value).set(col_b, value).set(col_c, value);
+    }
+    table.add_fulltext_index(col_b);
+    table.add_search_index(col_c);
+
+    // The indexes of the other columns must survive removal of a column
+    table.remove_column(col_a);
+    CHECK(table.has_fulltext_index(col_b));
+    CHECK(table.has_search_index(col_c));
+    CHECK_EQUAL(table.where().fulltext(col_b, "two").count(), 2);
+    CHECK_EQUAL(table.where().equal(col_c, "one two").count(), 1);
+    table.get_fulltext_index(col_b)->verify();
+
+    col_b = table.set_nullability(col_b, true, false);
+    CHECK(table.has_fulltext_index(col_b));
+    CHECK_NOT(table.has_search_index(col_b));
+    FullTextIndex* index = table.get_fulltext_index(col_b);
+    index->verify();
+    CHECK_EQUAL(index->count("three"), 2);
+    table.get_object(0).set_null(col_b);
+    CHECK_EQUAL(index->count("one"), 0);
+    CHECK_EQUAL(table.where().fulltext(col_b, "two").count(), 1);
+
+    table.remove_column(col_b);
+    CHECK(table.has_search_index(col_c));
+    CHECK_EQUAL(table.where().equal(col_c, "two three").count(), 1);
+}
+
+TEST(FullTextIndex_Transactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist);
+    ColKey col;
+
+    auto rt = db->start_read();
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        table->add_column(type_Int, "int");
+        col = table->add_column(type_String, "text");
+        table->add_fulltext_index(col);
+        table->create_object().set(col, "hello world");
+        wt->commit();
+    }
+
+    rt->advance_read();
+    {
+        auto table = rt->get_table("table");
+        CHECK(table->has_fulltext_index(col));
+        CHECK_NOT(table->has_search_index(col));
+        CHECK_EQUAL(table->where().fulltext(col, "world").count(), 1);
+        CHECK_EQUAL(table->where().contains(col, "o w").count(), 1);
+    }
+
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        table->create_object().set(col, "goodbye world");
+        table->get_object(0).set(col, "hello there");
+        table->get_fulltext_index(col)->verify();
+        wt->commit();
+    }
+
+    rt->advance_read();
+    {
+        auto table = rt->get_table("table");
+        FullTextIndex* index = table->get_fulltext_index(col);
+        CHECK(index);
+        index->verify();
+        CHECK_EQUAL(index->count("world"), 1);
+        CHECK_EQUAL(table->where().fulltext(col, "hello").count(), 1);
+    }
+
+    // Changes rolled back must leave the index as it was
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        table->create_object().set(col, "rolled back");
+        table->get_object(0).remove();
+        wt->rollback();
+    }
+
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        table->remove_fulltext_index(col);
+        table->add_search_index(col);
+        wt->commit();
+    }
+
+    rt->advance_read();
+    {
+        auto table = rt->get_table("table");
+        CHECK_NOT(table->has_fulltext_index(col));
+        CHECK(table->has_search_index(col));
+        CHECK_EQUAL(table->where().equal(col, "goodbye world").count(), 1);
+    }
+
+    // The index must be found when the file is opened again
+    rt = nullptr;
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        table->remove_search_index(col);
+        table->add_fulltext_index(col);
+        wt->commit();
+    }
+    db->close();
+    hist = make_in_realm_history(path);
+    db = DB::create(*hist);
+    {
+        auto rt2 = db->start_read();
+        // Older versions of the core library must refuse to open the file
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*rt2), 21);
+        rt2->verify();
+        auto table = rt2->get_table("table");
+        CHECK(table->has_fulltext_index(col));
+        table->get_fulltext_index(col)->verify();
+        CHECK_EQUAL(table->where().fulltext(col, "world").count(), 1);
+        CHECK_EQUAL(table->where().fulltext(col, "there hello").count(), 1);
+    }
+}
+
+#endif // TEST_INDEX_FULLTEXT
@@ -1695,4 +1695,120 @@ TEST(BackLink_Query_MultipleLevelsAndTables)
     CHECK_TABLE_VIEW(q.find_all(), {saved1});
 }
 
+TEST(LinkQuery_EvaluatedThroughBacklinks)
+{
+    Group g;
+    auto persons = g.add_table("persons");
+    auto dogs = g.add_table("dogs");
+    auto owners = g.add_table("owners");
+    auto col_name = persons->add_column(type_String, "name", true);
+    auto col_age = persons->add_column(type_Int, "age");
+    auto col_owner = dogs->add_column_link(type_Link, "owner", *persons);
+    auto col_friends = dogs->add_column_link(type_LinkList, "friends", *persons);
+    auto col_dog = owners->add_column_link(type_Link, "dog", *dogs);
+
+    std::vector<ObjKey> person_keys;
+    for (int i = 0; i < 20; ++i) {
+        auto name = (i % 5) ? StringData(std::string("name") + util::to_string(i % 7)) : StringData();
+        person_keys.push_back(persons->create_object().set(col_name, name).set(col_age, i).get_key());
+    }
+    for (int i = 0; i < 100; ++i) {
+        auto dog = dogs->create_object();
+        if (i % 4)
+            dog.set(col_owner, person_keys[(i * 7) % person_keys.size()]);
+        auto friends = dog.get_linklist(col_friends);
+        for (int j = 0; j < i % 3; ++j)
+            friends.add(person_keys[(i + j * 3) % person_keys.size()]);
+        owners->create_object().set(col_dog, dog.get_key());
+    }
+    // A link to an object which has been deleted
+    persons->invalidate_object(person_keys[1]);
+    // The target table must be small enough compared to the base table for
+    // the conditions to be evaluated there
+    for (int i = 0; i < 100; ++i)
+        dogs->create_object();
+
+    // Restricting a query to a view makes it follow the links forwards
+    TableView all_dogs = dogs->where().find_all();
+    TableView all_owners = owners->where().find_all();
+    TableView all_persons = persons->where().find_all();
+    auto check = [&](Query q, TableView& all) {
+        TableView all_copy = all;
+        auto expected = q.get_table()->where(&all_copy).and_query(q).find_all();
+        auto actual = q.find_all();
+        CHECK_EQUAL(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(actual.get_key(i), expected.get_key(i));
+        CHECK_EQUAL(q.count(), expected.size());
+    };
+
+    check(dogs->link(col_owner).column<String>(col_name) == "name3", all_dogs);
+    check(dogs->link(col_owner).column<String>(col_name).begins_with("name"), all_dogs);
+    check(dogs->link(col_owner).column<String>(col_name) != "name3", all_dogs);
+    check(dogs->link(col_owner).column<String>(col_name) == realm::null(), all_dogs);
+    check(dogs->link(col_owner).column<Int>(col_age) > 15, all_dogs);
+    check(dogs->link(col_owner).column<Int>(col_age) <= 0, all_dogs);
+    check(dogs->link(col_friends).column<String>(col_name) == "name2", all_dogs);
+    check(dogs->link(col_friends).column<Int>(col_age) != 3, all_dogs);
+    check(owners->link(col_dog).link(col_owner).column<Int>(col_age) < 5, all_owners);
+    check(owners->link(col_dog).link(col_friends).column<String>(col_name).contains("4"), all_owners);
+    check(persons->backlink(*dogs, col_owner).link(col_friends).column<Int>(col_age) == 0, all_persons);
+
+    Query q = dogs->link(col_owner).column<Int>(col_age) > 15;
+    CHECK_EQUAL(q.count(), (dogs->link(col_owner).column<Int>(col_age) >= 16).count());
+    CHECK_EQUAL(q.find(), (dogs->link(col_owner).column<Int>(col_age) >= 16).find());
+}
+
+TEST(LinkQuery_SubQueryCountLimitedAndCached)
+{
+    Group g;
+    auto persons = g.add_table("persons");
+    auto dogs = g.add_table("dogs");
+    auto col_age = persons->add_column(type_Int, "age");
+    auto col_friends = dogs->add_column_link(type_LinkList, "friends", *persons);
+
+    std::vector<ObjKey> person_keys;
+    for (int i = 0; i < 10; ++i)
+        person_keys.push_back(persons->create_object().set(col_age, i).get_key());
+    for (int i = 0; i < 200; ++i) {
+        auto friends = dogs->create_object().get_linklist(col_friends);
+        for (int j = 0; j < i % 6; ++j)
+            friends.add(person_keys[(i + j * 3) % person_keys.size()]);
+    }
+
+    auto expected_count = [&](int64_t min_age, util::FunctionRef<bool(size_t)> cond) {
+        size_t expected = 0;
+        for (auto dog : *dogs) {
+            auto friends = dog.get_linklist(col_friends);
+            size_t n = 0;
+            for (size_t i = 0; i < friends.size(); ++i)
+                n += friends.get_object(i).get<Int>(col_age) >= min_age;
+            expected += cond(n);
+        }
+        return expected;
+    };
+
+    for (int64_t min_age : {0, 5, 9, 10}) {
+        auto sub = [&] { return dogs->column<Link>(col_friends, persons->column<Int>(col_age) >= min_age).count(); };
+        CHECK_EQUAL((sub() > 0).count(), expected_count(min_age, [](size_t n) { return n > 0; }));
+        CHECK_EQUAL((sub() == 0).count(), expected_count(min_age, [](size_t n) { return n == 0; }));
+        CHECK_EQUAL((sub() == 2).count(), expected_count(min_age, [](size_t n) { return n == 2; }));
+        CHECK_EQUAL((sub() != 1).count(), expected_count(min_age, [](size_t n) { return n != 1; }));
+        CHECK_EQUAL((sub() < 3).count(), expected_count(min_age, [](size_t n) { return n < 3; }));
+        CHECK_EQUAL((sub() >= 4).count(), expected_count(min_age, [](size_t n) { return n >= 4; }));
+        CHECK_EQUAL((sub() > -1).count(), dogs->size());
+        CHECK_EQUAL((sub() < -1).count(), 0);
+        CHECK_EQUAL((sub() + 1 > 3).count(), expected_count(min_age, [](size_t n) { return n + 1 > 3; }));
+    }
+
+    // The cached results of the subquery are dropped when the table changes
+    Query q = dogs->column<Link>(col_friends, persons->column<Int>(col_age) > 7).count() >= 1;
+    CHECK_EQUAL(q.count(), expected_count(8, [](size_t n) { return n >= 1; }));
+    for (auto key : person_keys)
+        persons->get_object(key).set(col_age, 0);
+    CHECK_EQUAL(q.count(), 0);
+    persons->get_object(person_keys[3]).set(col_age, 8);
+    CHECK_EQUAL(q.count(), expected_count(8, [](size_t n) { return n >= 1; }));
+}
+
 #endif
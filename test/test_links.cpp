@@ -1594,4 +1594,52 @@ TEST(Links_DetachedAccessor)
     CHECK_NOT(link_list.is_attached());
 }
 
+TEST(Links_GetObjectsInBulk)
+{
+    Group g;
+    auto origin = g.add_table("origin");
+    auto target = g.add_table("target");
+    auto col_value = target->add_column(type_Int, "value");
+    auto col_links = origin->add_column_link(type_LinkList, "links", *target);
+
+    std::vector<ObjKey> target_keys;
+    for (int i = 0; i < 5000; ++i)
+        target_keys.push_back(target->create_object().set(col_value, i).get_key());
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    auto links = origin->create_object().get_linklist(col_links);
+    for (int i = 0; i < 1000; ++i)
+        links.add(target_keys[random.draw_int_mod(target_keys.size())]);
+
+    auto objects = links.get_objects();
+    CHECK_EQUAL(objects.size(), links.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        CHECK_EQUAL(objects[i].get_key(), links.get(i));
+        CHECK_EQUAL(objects[i].get<Int>(col_value), links.get_object(i).get<Int>(col_value));
+    }
+
+    // Links to deleted objects are skipped
+    target->invalidate_object(links.get(0));
+    links = origin->begin()->get_linklist(col_links);
+    objects = links.get_objects();
+    CHECK_EQUAL(objects.size(), links.size());
+    for (size_t i = 0; i < objects.size(); ++i)
+        CHECK_EQUAL(objects[i].get_key(), links.get(i));
+
+    // The keys of a table in any order, including duplicates
+    const Table& const_target = *target;
+    std::vector<ObjKey> keys = {target_keys[4999], target_keys[2], target_keys[4999], target_keys[2500]};
+    auto const_objects = const_target.get_objects(keys);
+    CHECK_EQUAL(const_objects.size(), 4);
+    CHECK_EQUAL(const_objects[0].get<Int>(col_value), 4999);
+    CHECK_EQUAL(const_objects[1].get<Int>(col_value), 2);
+    CHECK_EQUAL(const_objects[2].get<Int>(col_value), 4999);
+    CHECK_EQUAL(const_objects[3].get<Int>(col_value), 2500);
+    CHECK(target->get_objects({}).empty());
+
+    target->remove_object(target_keys[2500]);
+    CHECK_THROW(target->get_objects(keys), KeyNotFound);
+    CHECK_THROW(target->get_objects({ObjKey(100000)}), KeyNotFound);
+}
+
 #endif // TEST_LINKS
@@ -1093,6 +1093,108 @@ NONCONCURRENT_TEST_IF(Metrics_NumDecryptedPagesWithEncryption, REALM_ENABLE_ENCR
     CHECK_EQUAL(transactions->at(1).get_num_decrypted_pages(), 1);
 }
 
+// The page reclaimer must keep the decrypted pages of a file within the file's
+// budget even if the global governor does not ask for any pages to be released.
+NONCONCURRENT_TEST_IF(Metrics_DecryptedPageCacheBudget, REALM_ENABLE_ENCRYPTION)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBOptions options(crypt_key(true));
+    options.enable_metrics = true;
+    options.metrics_buffer_size = 10;
+    options.decrypted_page_cache_budget = 4 * page_size();
+    auto sg = DB::create(*hist, options);
+
+    {
+        auto wt = sg->start_write();
+        auto table = wt->add_table("table");
+        auto col = table->add_column(type_String, "str");
+        std::string str(100, 'x');
+        for (int i = 0; i < 2000; ++i)
+            table->create_object().set(col, StringData(str));
+        wt->commit();
+    }
+    {
+        // Visit every object twice, so that both misses and hits are recorded
+        auto rt = sg->start_read();
+        auto table = rt->get_table("table");
+        auto col = table->get_column_key("str");
+        for (int pass = 0; pass < 2; ++pass) {
+            for (auto& obj : *table)
+                CHECK_EQUAL(obj.get<String>(col).size(), 100);
+        }
+    }
+
+#if REALM_ENABLE_ENCRYPTION
+    {
+        // The first round clears the touched state of the pages, later rounds release them
+        NoPageReclaimGovernor gov;
+        realm::util::set_page_reclaim_governor(&gov);
+        auto on_exit = make_scope_exit([]() noexcept { realm::util::set_page_reclaim_governor_to_default(); });
+        REALM_ASSERT_RELEASE(gov.has_run_twice.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    }
+#endif
+
+    {
+        auto rt = sg->start_read();
+    }
+
+    std::shared_ptr<Metrics> metrics = sg->get_metrics();
+    CHECK(metrics);
+    std::unique_ptr<Metrics::TransactionInfoList> transactions = metrics->take_transactions();
+    CHECK(transactions);
+    CHECK_EQUAL(transactions->size(), 3);
+    const TransactionInfo& scan = transactions->at(1);
+    CHECK_GREATER(scan.get_num_page_cache_hits(), 0);
+    CHECK_GREATER(scan.get_num_page_cache_misses(), 0);
+    const TransactionInfo& last = transactions->at(2);
+    CHECK_GREATER(last.get_num_page_cache_evictions(), 0);
+    CHECK_GREATER_EQUAL(last.get_num_page_cache_misses(), scan.get_num_page_cache_misses());
+}
+
+TEST(Metrics_WriteLockTimes)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist_1(make_in_realm_history(path));
+    std::unique_ptr<Replication> hist_2(make_in_realm_history(path));
+    DBOptions options(crypt_key());
+    options.enable_metrics = true;
+    options.metrics_buffer_size = 10;
+    // Separate DB objects, as metrics of concurrent writers would be mixed up
+    auto sg_1 = DB::create(*hist_1, options);
+    auto sg_2 = DB::create(*hist_2, options);
+
+    auto wt = sg_1->start_write();
+    wt->add_table("table");
+    std::thread waiter([&] {
+        auto wt_2 = sg_2->start_write();
+        wt_2->commit();
+    });
+    millisleep(100);
+    wt->commit();
+    waiter.join();
+
+    auto last_write = [](DBRef sg) {
+        auto transactions = sg->get_metrics()->take_transactions();
+        TransactionInfo info(TransactionInfo::read_transaction);
+        for (auto& transaction : *transactions) {
+            if (transaction.get_transaction_type() == TransactionInfo::write_transaction)
+                info = transaction;
+        }
+        return info;
+    };
+    const nanosecond_storage_t min_time = 50 * 1000 * 1000;
+    TransactionInfo first = last_write(sg_1);
+    CHECK_EQUAL(first.get_transaction_type(), TransactionInfo::write_transaction);
+    CHECK_LESS(first.get_write_lock_wait_time_nanoseconds(), min_time);
+    CHECK_GREATER(first.get_write_lock_hold_time_nanoseconds(), min_time);
+    TransactionInfo second = last_write(sg_2);
+    CHECK_EQUAL(second.get_transaction_type(), TransactionInfo::write_transaction);
+    CHECK_GREATER(second.get_write_lock_wait_time_nanoseconds(), min_time);
+    CHECK_GREATER(second.get_write_lock_hold_time_nanoseconds(), 0);
+    CHECK_LESS(second.get_write_lock_hold_time_nanoseconds(), min_time);
+}
+
 TEST(Metrics_MemoryChecks)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -1172,6 +1274,11 @@ TEST(Metrics_APIAvailability)
                 transaction.get_total_objects();
                 transaction.get_num_available_versions();
                 transaction.get_num_decrypted_pages();
+                transaction.get_num_page_cache_hits();
+                transaction.get_num_page_cache_misses();
+                transaction.get_num_page_cache_evictions();
+                transaction.get_write_lock_wait_time_nanoseconds();
+                transaction.get_write_lock_hold_time_nanoseconds();
             }
         }
         std::unique_ptr<Metrics::QueryInfoList> queries = metrics->take_queries();
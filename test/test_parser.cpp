@@ -790,6 +790,40 @@ TEST(Parser_StringOperations)
 }
 
 
+TEST(Parser_FullText)
+{
+    Group g;
+    TableRef t = g.add_table("book");
+    ColKey title_col = t->add_column(type_String, "title", true);
+    t->add_column_link(type_Link, "sequel", *t);
+    std::vector<std::string> titles = {"The Fellowship of the Ring", "The Two Towers", "The Return of the King",
+                                       "Ring of fire"};
+    for (auto& title : titles) {
+        t->create_object().set(title_col, StringData(title));
+    }
+    t->create_object(); // null
+
+    auto check_queries = [&] {
+        verify_query(test_context, t, "title TEXT 'ring'", 2);
+        verify_query(test_context, t, "title TEXT 'the ring'", 1);
+        verify_query(test_context, t, "title TEXT 'KING the'", 1);
+        verify_query(test_context, t, "title TEXT 'towers of'", 0);
+        verify_query(test_context, t, "title TEXT 'ring' AND title BEGINSWITH 'R'", 1);
+        verify_query(test_context, t, "NOT title TEXT 'the'", 2);
+    };
+    check_queries();
+    t->add_fulltext_index(title_col);
+    check_queries();
+    verify_query(test_context, t, "title CONTAINS ' of the '", 2);
+    verify_query(test_context, t, "title CONTAINS[c] 'ING'", 3);
+
+    // Only supported directly between a string property and a string literal
+    CHECK_THROW_ANY(verify_query(test_context, t, "sequel.title TEXT 'ring'", 0));
+    CHECK_THROW_ANY(verify_query(test_context, t, "title TEXT title", 0));
+    CHECK_THROW_ANY(verify_query(test_context, t, "'ring' TEXT title", 0));
+}
+
+
 TEST(Parser_Timestamps)
 {
     Group g;
@@ -4364,4 +4398,60 @@ TEST(Parser_Decimal128)
 }
 
 
+TEST(Parser_PreparedQuery)
+{
+    Group g;
+    TableRef people = g.add_table("person");
+    ColKey name_col = people->add_column(type_String, "name");
+    ColKey age_col = people->add_column(type_Int, "age");
+    for (int i = 0; i < 10; ++i)
+        people->create_object().set(name_col, i % 2 ? "odd" : "even").set(age_col, i);
+
+    parser::ParserCache cache(2);
+    query_builder::AnyContext ctx;
+    auto count = [&](const query_builder::PreparedQuery& prepared, util::Any name, util::Any age) {
+        util::Any args[] = {name, age};
+        query_builder::ArgumentConverter<util::Any, query_builder::AnyContext> converter(ctx, args, 2);
+        return prepared.bind(people, converter).count();
+    };
+
+    const std::string query_string = "name == $0 && age >= $1 SORT(age DESC) LIMIT(2)";
+    query_builder::PreparedQuery prepared(cache, query_string);
+    CHECK_EQUAL(count(prepared, StringData("odd"), Int(0)), 5);
+    CHECK_EQUAL(count(prepared, StringData("even"), Int(5)), 2);
+    CHECK_EQUAL(count(prepared, StringData("none"), Int(0)), 0);
+
+    // A second prepared query of the same string shares the parsed predicate
+    query_builder::PreparedQuery prepared_2(cache, query_string);
+    CHECK_EQUAL(&prepared.get_parser_result(), &prepared_2.get_parser_result());
+    CHECK_EQUAL(cache.get_miss_count(), 1);
+    CHECK_EQUAL(cache.get_hit_count(), 1);
+
+    util::Any args[] = {StringData("odd"), Int(0)};
+    query_builder::ArgumentConverter<util::Any, query_builder::AnyContext> converter(ctx, args, 2);
+    DescriptorOrdering ordering;
+    prepared_2.bind_ordering(ordering, people, converter);
+    TableView tv = prepared_2.bind(people, converter).find_all(ordering);
+    CHECK_EQUAL(tv.size(), 2);
+    CHECK_EQUAL(tv.get(0).get<Int>(age_col), 9);
+    CHECK_EQUAL(tv.get(1).get<Int>(age_col), 7);
+
+    // The least recently used string is evicted
+    query_builder::PreparedQuery other(cache, "age > 5");
+    query_builder::PreparedQuery prepared_3(cache, query_string);
+    CHECK_EQUAL(&prepared.get_parser_result(), &prepared_3.get_parser_result());
+    query_builder::PreparedQuery third(cache, "age < 5");
+    CHECK_EQUAL(cache.size(), 2);
+    query_builder::PreparedQuery other_2(cache, "age > 5");
+    CHECK_NOT_EQUAL(&other.get_parser_result(), &other_2.get_parser_result());
+    CHECK_EQUAL(cache.get_miss_count(), 4);
+
+    // Invalid strings are not cached
+    CHECK_THROW_ANY(query_builder::PreparedQuery(cache, "age >"));
+    CHECK_EQUAL(cache.size(), 2);
+    cache.clear();
+    CHECK_EQUAL(cache.size(), 0);
+}
+
+
 #endif // TEST_PARSER
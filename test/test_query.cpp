@@ -5390,4 +5390,42 @@ TEST(Query_AllocatorBug)
     CHECK_EQUAL(cnt, 421);
 }
 
+TEST(Query_EncryptedScan)
+{
+    // Scans of an encrypted file prefetch the leaves of each cluster before
+    // reading them, which must not change the results
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist, DBOptions(crypt_key(true)));
+    ColKey col_a, col_b, col_c;
+    const int64_t num_objects = 5000;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col_a = table->add_column(type_Int, "a");
+        col_b = table->add_column(type_Int, "b");
+        col_c = table->add_column(type_String, "c");
+        for (int64_t i = 0; i < num_objects; ++i) {
+            table->create_object().set(col_a, i).set(col_b, i % 7).set(col_c, i % 2 ? "odd" : "even");
+        }
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    Query q = table->where().greater_equal(col_a, 1000).equal(col_b, 3).equal(col_c, "odd");
+    size_t expected = 0;
+    int64_t expected_sum = 0;
+    for (int64_t i = 1000; i < num_objects; ++i) {
+        if (i % 7 == 3 && i % 2) {
+            ++expected;
+            expected_sum += i;
+        }
+    }
+    CHECK_EQUAL(q.count(), expected);
+    CHECK_EQUAL(q.find_all().size(), expected);
+    CHECK_EQUAL(q.sum_int(col_a), expected_sum);
+    CHECK_EQUAL(table->get_object(q.find()).get<Int>(col_a), 1011);
+}
+
 #endif // TEST_QUERY
@@ -33,6 +33,7 @@
 #include <realm/query_expression.hpp>
 #include "test.hpp"
 #include "test_table_helper.hpp"
+#include "util/check_logic_error.hpp"
 
 using namespace realm;
 using namespace realm::util;
@@ -5313,4 +5314,247 @@ TEST(Query_NotImmediatelyBeforeKnownRange)
     CHECK_EQUAL(q.count(), 1);
 }
 
+TEST(Query_PlanFromIndexStatistics)
+{
+    Table table;
+    auto col_name = table.add_column(type_String, "name");
+    auto col_age = table.add_column(type_Int, "age");
+    table.add_search_index(col_name);
+    for (int i = 0; i < 1000; ++i)
+        table.create_object().set(col_name, i % 500 ? "common" : "rare").set(col_age, i % 100);
+
+    // Few matches in the index: the index drives the query
+    Query q = table.where().greater(col_age, 5).equal(col_name, "rare");
+    std::string plan = q.explain();
+    CHECK(plan.find("1000 objects") != std::string::npos);
+    CHECK(plan.find("Driven by the search index") != std::string::npos);
+    CHECK(plan.find("1. name == \"rare\": index, 2 matches") != std::string::npos);
+    CHECK(plan.find("2. age > 5: scan") != std::string::npos);
+    CHECK_EQUAL(q.count(), 0);
+    CHECK_EQUAL(table.where().less(col_age, 5).equal(col_name, "rare").count(), 2);
+
+    // Most objects match the index: the table is traversed and the more
+    // selective scan is evaluated first
+    q = table.where().equal(col_name, "common").equal(col_age, 3);
+    plan = q.explain();
+    CHECK(plan.find("Traversal of all objects") != std::string::npos);
+    CHECK(plan.find("1. age == 3: scan") != std::string::npos);
+    CHECK(plan.find("2. name == \"common\": index, 998 matches") != std::string::npos);
+    CHECK_EQUAL(q.count(), 10);
+    CHECK_EQUAL(q.find_all().size(), 10);
+    CHECK_EQUAL(q.find(), table.where().equal(col_age, 3).find());
+
+    // Restricted to a view
+    TableView view = table.where().less(col_age, 10).find_all();
+    q = table.where(&view).equal(col_name, "rare");
+    CHECK(q.explain().find("restricting view") != std::string::npos);
+    CHECK_EQUAL(q.count(), 2);
+
+    CHECK(table.where().explain().find("No conditions") != std::string::npos);
+}
+
+TEST(Query_EstimateCount)
+{
+    Table table;
+    auto col_name = table.add_column(type_String, "name");
+    auto col_age = table.add_column(type_Int, "age");
+    table.add_search_index(col_name);
+    for (int i = 0; i < 20000; ++i)
+        table.create_object().set(col_name, i % 4000 ? "common" : "rare").set(col_age, i % 10);
+
+    // No conditions
+    auto estimate = table.where().estimate_count();
+    CHECK(estimate.exact);
+    CHECK_EQUAL(estimate.count, 20000);
+
+    // Sampled, also for periodic data
+    for (int64_t age = 0; age < 10; ++age) {
+        estimate = table.where().equal(col_age, age).estimate_count();
+        CHECK(!estimate.exact);
+        CHECK_LESS_EQUAL(estimate.lower, 2000);
+        CHECK_GREATER_EQUAL(estimate.upper, 2000);
+        CHECK_LESS(estimate.upper - estimate.lower, 1000);
+        CHECK_LESS_EQUAL(estimate.lower, estimate.count);
+        CHECK_LESS_EQUAL(estimate.count, estimate.upper);
+    }
+    estimate = table.where().less(col_age, 0).estimate_count();
+    CHECK_EQUAL(estimate.lower, 0);
+    CHECK_EQUAL(estimate.count, 0);
+    CHECK_LESS(estimate.upper, 200);
+
+    // Bounded by the matches of the search index, exact if they drive the query
+    estimate = table.where().equal(col_name, "rare").greater(col_age, -1).estimate_count();
+    CHECK(estimate.exact);
+    CHECK_EQUAL(estimate.count, 5);
+    estimate = table.where().equal(col_name, "common").equal(col_age, 0).estimate_count(100);
+    CHECK(!estimate.exact);
+    CHECK_LESS_EQUAL(estimate.lower, 1995);
+    CHECK_GREATER_EQUAL(estimate.upper, 1995);
+
+    // Small enough to count
+    TableView view = table.where().equal(col_age, 5).find_all();
+    estimate = table.where(&view).equal(col_name, "common").estimate_count(5000);
+    CHECK(estimate.exact);
+    CHECK_EQUAL(estimate.count, 2000);
+    estimate = table.where(&view).less(col_age, 5).estimate_count(100);
+    CHECK(!estimate.exact);
+    CHECK_EQUAL(estimate.count, 0);
+}
+
+TEST(Query_Cursor)
+{
+    Table table;
+    auto col_name = table.add_column(type_String, "name");
+    auto col_int = table.add_column(type_Int, "int");
+    table.add_search_index(col_name);
+    for (int i = 0; i < 5000; ++i)
+        table.create_object().set(col_name, i % 100 ? "common" : "rare").set(col_int, i % 7);
+
+    auto check_cursor = [&](const Query& q, size_t batch_size) {
+        TableView expected = Query(q).find_all();
+        std::vector<ObjKey> keys;
+        std::vector<ObjKey> batch;
+        QueryCursor cursor(q, batch_size);
+        while (cursor.next_batch(batch)) {
+            CHECK_LESS_EQUAL(batch.size(), batch_size);
+            keys.insert(keys.end(), batch.begin(), batch.end());
+        }
+        CHECK_NOT(cursor.next());
+        CHECK_EQUAL(keys.size(), expected.size());
+        for (size_t i = 0; i < keys.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(keys[i], expected.get_key(i));
+
+        QueryCursor single(q, batch_size);
+        size_t n = 0;
+        while (ObjKey key = single.next()) {
+            if (n < expected.size())
+                CHECK_EQUAL(key, expected.get_key(n));
+            ++n;
+        }
+        CHECK_EQUAL(n, expected.size());
+    };
+
+    check_cursor(table.where(), 1000);
+    check_cursor(table.where().equal(col_int, 3), 100);
+    check_cursor(table.where().equal(col_int, 3), 1);
+    check_cursor(table.where().equal(col_name, "rare"), 7);
+    check_cursor(table.where().equal(col_name, "rare").equal(col_int, 2), 3);
+    check_cursor(table.where().equal(col_int, 7), 10);
+
+    TableView view = table.where().less(col_int, 2).find_all();
+    check_cursor(table.where(&view).equal(col_name, "rare"), 5);
+
+    // Continues behind the last returned match across modifications
+    QueryCursor cursor(table.where().equal(col_int, 3), 10);
+    std::vector<ObjKey> batch;
+    CHECK(cursor.next_batch(batch));
+    ObjKey last = batch.back();
+    while (table.size() > 4000)
+        table.remove_object(table.get_object(table.size() - 1).get_key());
+    table.create_object().set(col_int, 3);
+    size_t remaining = 0;
+    while (cursor.next_batch(batch)) {
+        for (auto key : batch) {
+            CHECK_LESS(last, key);
+            last = key;
+            CHECK_EQUAL(table.get_object(key).get<Int>(col_int), 3);
+        }
+        remaining += batch.size();
+    }
+    CHECK_EQUAL(remaining + 10, table.where().equal(col_int, 3).count());
+}
+
+TEST(Query_GroupBy)
+{
+    Group g;
+    auto categories = g.add_table("categories");
+    auto col_title = categories->add_column(type_String, "title");
+    auto items = g.add_table("items");
+    auto col_category = items->add_column_link(type_Link, "category", *categories);
+    auto col_kind = items->add_column(type_Int, "kind");
+    auto col_price = items->add_column(type_Double, "price");
+    auto col_amount = items->add_column(type_Int, "amount", true);
+    auto col_cost = items->add_column(type_Decimal, "cost");
+
+    ObjKey cat_a = categories->create_object().set(col_title, "a").get_key();
+    ObjKey cat_b = categories->create_object().set(col_title, "b").get_key();
+    for (int i = 0; i < 3000; ++i) {
+        auto obj = items->create_object().set(col_kind, i % 3).set(col_price, double(i)).set(col_cost,
+                                                                                             Decimal128(i % 10));
+        if (i % 2)
+            obj.set(col_category, i % 4 == 1 ? cat_a : cat_b);
+        if (i % 5)
+            obj.set(col_amount, 1);
+    }
+
+    using Op = Query::GroupOp;
+    auto groups = items->where().greater(col_price, 5.5).group_by(
+        {{col_kind}}, {{Op::sum, {col_price}}, {Op::min, {col_price}}, {Op::max, {col_price}},
+                       {Op::average, {col_price}}, {Op::sum, {col_amount}}, {Op::average, {col_cost}}});
+    CHECK_EQUAL(groups.size(), 3);
+    for (auto& group : groups) {
+        int64_t kind = group.keys[0].get_int();
+        Query q = items->where().greater(col_price, 5.5).equal(col_kind, kind);
+        CHECK_EQUAL(group.count, q.count());
+        CHECK_EQUAL(group.values[0].get_double(), q.sum_double(col_price));
+        CHECK_EQUAL(group.values[1].get_double(), q.minimum_double(col_price));
+        CHECK_EQUAL(group.values[2].get_double(), q.maximum_double(col_price));
+        CHECK_APPROXIMATELY_EQUAL(group.values[3].get_double(), q.average_double(col_price), 1e-9);
+        CHECK_EQUAL(group.values[4].get_int(), q.sum_int(col_amount));
+        CHECK_EQUAL(group.values[5].get<Decimal128>(), q.average_decimal128(col_cost));
+    }
+    // Groups are in the order of their first match
+    CHECK_EQUAL(groups[0].keys[0].get_int(), 0);
+    CHECK_EQUAL(groups[1].keys[0].get_int(), 1);
+
+    // Across a link, and by several columns
+    groups = items->where().group_by({{col_category, col_title}, {col_kind}}, {{Op::max, {col_price}}});
+    CHECK_EQUAL(groups.size(), 9);
+    size_t total = 0;
+    for (auto& group : groups) {
+        total += group.count;
+        Query q = items->where().equal(col_kind, group.keys[1].get_int());
+        if (group.keys[0].is_null())
+            q.and_query(items->column<Link>(col_category).is_null());
+        else
+            q.links_to(col_category, group.keys[0].get_string() == "a" ? cat_a : cat_b);
+        CHECK_EQUAL(group.count, q.count());
+        CHECK_EQUAL(group.values[0].get_double(), q.maximum_double(col_price));
+    }
+    CHECK_EQUAL(total, 3000);
+
+    // Restricted to a view
+    TableView view = items->where().links_to(col_category, cat_a).find_all();
+    groups = items->where(&view).group_by({{col_category}}, {{Op::average, {col_amount}}});
+    CHECK_EQUAL(groups.size(), 1);
+    CHECK_EQUAL(groups[0].keys[0].get<ObjKey>(), cat_a);
+    CHECK_EQUAL(groups[0].count, 750);
+
+    // By a decimal column, where equal values have several representations
+    CHECK_EQUAL(Mixed(Decimal128("2.5")).hash(), Mixed(Decimal128("2.500")).hash());
+    CHECK_EQUAL(Mixed(Decimal128("-0")).hash(), Mixed(Decimal128("0E+10")).hash());
+    CHECK_NOT_EQUAL(Mixed(Decimal128("2.5")).hash(), Mixed(Decimal128("25")).hash());
+    auto col_rate = items->add_column(type_Decimal, "rate");
+    int n = 0;
+    for (auto obj : *items) {
+        int k = n % 10;
+        obj.set(col_rate, n++ % 4 < 2 ? Decimal128(k) : Decimal128(util::to_string(k) + ".00"));
+    }
+    groups = items->where().group_by({{col_rate}}, {{Op::sum, {col_cost}}});
+    CHECK_EQUAL(groups.size(), 10);
+    for (auto& group : groups)
+        CHECK_EQUAL(group.count, 300);
+    TableView distinct = items->where().find_all();
+    distinct.distinct(col_rate);
+    CHECK_EQUAL(distinct.size(), 10);
+
+    // No matches
+    CHECK(items->where().less(col_price, 0.).group_by({{col_kind}}).empty());
+
+    CHECK_LOGIC_ERROR(items->where().group_by({{ColKey()}}), LogicError::column_does_not_exist);
+    CHECK_LOGIC_ERROR(items->where().group_by({{col_kind, col_price}}), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(items->where().group_by({{col_kind}}, {{Op::sum, {col_category, col_title}}}),
+                            LogicError::type_mismatch);
+}
+
 #endif // TEST_QUERY
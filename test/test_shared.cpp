@@ -2423,6 +2423,72 @@ TEST(Shared_WaitForChange)
 }
 #endif
 
+TEST(Shared_WaitForChangeTables)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    TableKey key_a, key_b;
+    {
+        WriteTransaction wt(sg);
+        key_a = wt.add_table("a")->get_key();
+        key_b = wt.add_table("b")->get_key();
+        wt.commit();
+    }
+    auto modify = [&](TableKey key) {
+        WriteTransaction wt(sg);
+        wt.get_table(key)->create_object();
+        wt.commit();
+    };
+
+    // A change to another table does not wake the waiter
+    TransactionRef rt = sg->start_read();
+    std::atomic<bool> woken(false);
+    std::thread waiter([&] {
+        CHECK(sg->wait_for_change(rt, {key_a}));
+        woken = true;
+    });
+    modify(key_b);
+    millisleep(100);
+    CHECK_NOT(woken);
+    modify(key_a);
+    waiter.join();
+    CHECK(woken);
+
+    // Changes made since the transaction started are reported at once
+    CHECK(sg->wait_for_change(rt, {key_b}));
+    CHECK(sg->wait_for_change(rt));
+
+    // Adding or removing any table wakes every filtered waiter
+    for (bool add : {true, false}) {
+        rt = sg->start_read();
+        woken = false;
+        std::thread waiter_3([&] {
+            CHECK(sg->wait_for_change(rt, {key_a}));
+            woken = true;
+        });
+        millisleep(100);
+        CHECK_NOT(woken);
+        {
+            WriteTransaction wt(sg);
+            if (add)
+                wt.add_table("c");
+            else
+                wt.get_group().remove_table("c");
+            wt.commit();
+        }
+        waiter_3.join();
+        CHECK(woken);
+    }
+
+    // Filtered waiters are released as well
+    rt = sg->start_read();
+    std::thread waiter_2([&] { CHECK_NOT(sg->wait_for_change(rt, {key_a})); });
+    millisleep(100);
+    sg->wait_for_change_release();
+    waiter_2.join();
+    sg->enable_wait_for_change();
+}
+
 TEST(Shared_MultipleSharersOfStreamingFormat)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -2680,6 +2746,305 @@ TEST(Shared_VersionCount)
     CHECK_EQUAL(2, sg->get_number_of_versions());
 }
 
+// Read transactions on the same version share one count in the ringbuffer.
+// The version must stay alive until the last of them has ended.
+TEST(Shared_VersionCountSharedReaders)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path);
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("table")->add_column(type_Int, "int");
+        wt.commit();
+    }
+    TransactionRef reader_1 = sg->start_read();
+    TransactionRef reader_2 = sg->start_read();
+    TransactionRef reader_3 = sg->start_read(reader_1->get_version_of_current_transaction());
+    CHECK_EQUAL(reader_1->get_version(), reader_2->get_version());
+    CHECK_EQUAL(reader_1->get_version(), reader_3->get_version());
+
+    auto commit = [&] {
+        WriteTransaction wt(sg);
+        wt.get_table("table")->create_object();
+        wt.commit();
+    };
+    commit();
+    commit();
+    CHECK_EQUAL(3, sg->get_number_of_versions());
+
+    reader_1->close();
+    reader_3->close();
+    commit();
+    // Still held by reader_2
+    CHECK_EQUAL(4, sg->get_number_of_versions());
+    CHECK_EQUAL(reader_2->get_table("table")->size(), 0);
+    // A new reader on the same version must still succeed
+    TransactionRef reader_4 = sg->start_read(reader_2->get_version_of_current_transaction());
+    CHECK_EQUAL(reader_4->get_table("table")->size(), 0);
+
+    reader_2->close();
+    commit();
+    CHECK_EQUAL(5, sg->get_number_of_versions());
+    reader_4->close();
+    commit();
+    CHECK_EQUAL(2, sg->get_number_of_versions());
+}
+
+// Readers sharing a version take and release their locks without the DB mutex
+// while a writer keeps adding versions. No version may stay locked afterwards.
+TEST(Shared_ConcurrentSharedReaders)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path);
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("table")->add_column(type_Int, "int");
+        wt.commit();
+    }
+    auto commit = [&] {
+        WriteTransaction wt(sg);
+        wt.get_table("table")->create_object();
+        wt.commit();
+    };
+
+    const int num_readers = 4;
+    const int num_commits = 50;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < num_readers; ++i) {
+        readers.emplace_back([&] {
+            while (!done) {
+                TransactionRef rt = sg->start_read();
+                size_t size = rt->get_table("table")->size();
+                TransactionRef same = sg->start_read(rt->get_version_of_current_transaction());
+                CHECK_EQUAL(same->get_table("table")->size(), size);
+                rt->close();
+                CHECK_EQUAL(same->get_table("table")->size(), size);
+            }
+        });
+    }
+    for (int i = 0; i < num_commits; ++i)
+        commit();
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    commit();
+    CHECK_EQUAL(2, sg->get_number_of_versions());
+}
+
+TEST(Shared_StartReadPooled)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef sg = DB::create(*hist, DBOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("a")->add_column(type_Int, "int");
+        wt.add_table("b")->add_column(type_Int, "int");
+        wt.commit();
+    }
+    const Table* accessor_a;
+    {
+        TransactionRef rt = sg->start_read_pooled();
+        accessor_a = rt->get_table("a").unchecked_ptr();
+        CHECK_EQUAL(rt->get_table("a")->size(), 0);
+        CHECK_EQUAL(rt->get_table("b")->size(), 0);
+    }
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("a")->create_object().set("int", 7);
+        wt.get_group().remove_table("b");
+        wt.add_table("c")->add_column(type_String, "str");
+        wt.commit();
+    }
+    {
+        // The recycled transaction must see the latest snapshot, and keep the
+        // accessor of the surviving table
+        TransactionRef rt = sg->start_read_pooled();
+        CHECK_EQUAL(rt->get_version_of_current_transaction().version, sg->get_version_of_latest_snapshot());
+        auto a = rt->get_table("a");
+        CHECK_EQUAL(a.unchecked_ptr(), accessor_a);
+        CHECK_EQUAL(a->size(), 1);
+        CHECK_EQUAL(a->begin()->get<Int>("int"), 7);
+        CHECK_NOT(rt->has_table("b"));
+        CHECK(rt->has_table("c"));
+        CHECK_EQUAL(rt->get_table("c")->get_column_count(), 1);
+        CHECK_EQUAL(rt->size(), 2);
+
+        // Two pooled transactions may be live at the same time
+        TransactionRef rt_2 = sg->start_read_pooled(rt->get_version_of_current_transaction());
+        CHECK_EQUAL(rt_2->get_table("a")->size(), 1);
+    }
+    {
+        // A transaction which is no longer reading is not recycled
+        TransactionRef rt = sg->start_read_pooled();
+        rt->close();
+    }
+    {
+        // Promote a pooled transaction to a write transaction
+        TransactionRef rt = sg->start_read_pooled();
+        rt->promote_to_write();
+        rt->get_table("a")->create_object();
+        rt->commit_and_continue_as_read();
+        CHECK_EQUAL(rt->get_table("a")->size(), 2);
+    }
+    {
+        TransactionRef rt = sg->start_read_pooled();
+        CHECK_EQUAL(rt->get_table("a")->size(), 2);
+        // Leave a live pooled transaction behind, then release it after the
+        // pool has been filled
+        TransactionRef keep = sg->start_read_pooled();
+        rt = nullptr;
+        CHECK_EQUAL(keep->get_table("a")->size(), 2);
+    }
+    // Closing the DB must release the transactions in the pool
+    sg->close();
+    CHECK_NOT(sg->is_attached());
+}
+
+
+// A pooled transaction last bound to version N+k may be rebound to version N,
+// and references obtained by its previous user must stay invalid.
+TEST(Shared_StartReadPooledOlderVersion)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("a")->add_column(type_Int, "int");
+        wt.commit();
+    }
+    TransactionRef old_reader = sg->start_read();
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("a")->create_object();
+        wt.add_table("b")->add_column(type_Int, "int");
+        wt.add_table("c")->add_column(type_String, "str");
+        wt.commit();
+    }
+    ConstTableRef stale;
+    {
+        TransactionRef rt = sg->start_read_pooled();
+        CHECK_EQUAL(rt->size(), 3);
+        CHECK_EQUAL(rt->get_table("b")->size(), 0);
+        CHECK_EQUAL(rt->get_table("c")->size(), 0);
+        stale = rt->get_table("a");
+        CHECK_EQUAL(stale->size(), 1);
+    }
+    CHECK_NOT(stale);
+    CHECK_THROW(stale->size(), NoSuchTable);
+    {
+        TransactionRef rt = sg->start_read_pooled(old_reader->get_version_of_current_transaction());
+        CHECK_NOT(stale);
+        CHECK_EQUAL(rt->size(), 1);
+        CHECK_NOT(rt->has_table("b"));
+        CHECK_EQUAL(rt->get_table("a")->size(), 0);
+    }
+    {
+        // And forwards again
+        TransactionRef rt = sg->start_read_pooled();
+        CHECK_NOT(stale);
+        CHECK_EQUAL(rt->size(), 3);
+        CHECK_EQUAL(rt->get_table("a")->size(), 1);
+    }
+}
+
+
+TEST(Shared_WritePriority)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("table")->add_column(type_String, "writer");
+        wt.commit();
+    }
+    auto write = [&](DB::WritePriority priority, const char* name) {
+        auto wt = sg->start_write(priority);
+        wt->get_table("table")->create_object().set("writer", name);
+        wt->commit();
+    };
+
+    // A background writer lets an interactive writer which is already waiting
+    // go first
+    auto wt = sg->start_write();
+    std::thread interactive(write, DB::WritePriority::interactive, "interactive");
+    millisleep(100);
+    std::thread background(write, DB::WritePriority::background, "background");
+    millisleep(100);
+    wt->commit();
+    interactive.join();
+    background.join();
+
+    auto rt = sg->start_read();
+    auto table = rt->get_table("table");
+    auto col = table->get_column_key("writer");
+    CHECK_EQUAL(table->size(), 2);
+    CHECK_EQUAL(table->begin()->get<String>(col), "interactive");
+    CHECK_EQUAL((table->begin() + 1)->get<String>(col), "background");
+
+    // Without competition, a background writer does not wait
+    auto start = std::chrono::steady_clock::now();
+    write(DB::WritePriority::background, "alone");
+    CHECK(std::chrono::steady_clock::now() - start < DB::max_background_write_yield);
+}
+
+#ifdef ENABLE_ROBUST_AGAINST_DEATH_DURING_WRITE
+// An interactive writer in a process which dies while waiting for the write
+// lock must not make background writers yield to it afterwards.
+TEST(Shared_WritePriorityDeadWaiter)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path);
+    auto wt = sg->start_write();
+    pid_t pid = fork();
+    if (pid == pid_t(-1))
+        REALM_TERMINATE("fork() failed");
+    if (pid == 0) {
+        // Waits until it is killed
+        DBRef db = DB::create(path);
+        db->start_write();
+        _Exit(0);
+    }
+    millisleep(200);
+    kill(pid, SIGKILL);
+    int stat_loc = 0;
+    CHECK_EQUAL(waitpid(pid, &stat_loc, 0), pid);
+    wt->commit();
+
+    auto start = std::chrono::steady_clock::now();
+    auto tr = sg->start_write(DB::WritePriority::background);
+    CHECK(std::chrono::steady_clock::now() - start < DB::max_background_write_yield);
+}
+#endif
+
+TEST(Shared_WriteTimeout)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    auto wt = sg->start_write();
+    wt->add_table("table");
+
+    std::thread waiter([&] {
+        for (auto priority : {DB::WritePriority::interactive, DB::WritePriority::background}) {
+            auto start = std::chrono::steady_clock::now();
+            auto tr = sg->start_write(priority, std::chrono::milliseconds(20));
+            CHECK_NOT(tr);
+            CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+        }
+    });
+    waiter.join();
+    wt->commit();
+
+    // The lock is free now
+    auto tr = sg->start_write(DB::WritePriority::interactive, std::chrono::milliseconds(20));
+    CHECK(tr);
+    CHECK(tr->has_table("table"));
+    tr->rollback();
+    CHECK(sg->start_write(DB::WritePriority::background, std::chrono::milliseconds(0)));
+}
+
 TEST(Shared_MultipleRollbacks)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -2941,6 +3306,261 @@ TEST(Shared_CompactEmpty)
 }
 
 
+TEST(Shared_SectionMapFlags)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.section_map_flags = util::File::map_Populate | util::File::map_Random;
+    DBRef sg = DB::create(path, false, options);
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 1000; ++i)
+            table->create_object().set(col, i);
+        wt.commit();
+    }
+    {
+        ReadTransaction rt(sg);
+        auto table = rt.get_table("table");
+        CHECK_EQUAL(table->size(), 1000);
+    }
+
+    auto stats = sg->get_section_stats();
+    CHECK_GREATER(stats.size(), 0);
+    CHECK_EQUAL(stats[0].offset, 0);
+    for (auto& section : stats) {
+        CHECK_GREATER(section.size, 0);
+        CHECK_LESS_EQUAL(section.resident_size, section.size);
+        CHECK_LESS_EQUAL(section.huge_page_size, section.size);
+    }
+}
+
+TEST(Shared_WriteMemoryLimit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    TEST_DIR(dir);
+    DBOptions options;
+    options.temp_dir = dir;
+    options.write_memory_limit = 256 * 1024;
+    DBRef sg = DB::create(path, false, options);
+    std::string payload(200, 'x');
+    for (int round = 0; round < 2; ++round) {
+        // Several megabytes of modified data in a single transaction
+        WriteTransaction wt(sg);
+        auto table = round == 0 ? wt.add_table("table") : wt.get_table("table");
+        if (round == 0) {
+            table->add_column(type_Int, "int");
+            table->add_column(type_String, "string");
+        }
+        auto col_int = table->get_column_key("int");
+        auto col_str = table->get_column_key("string");
+        for (int i = 0; i < 20000; ++i)
+            table->create_object().set(col_int, i).set(col_str, payload);
+        wt.commit();
+    }
+    ReadTransaction rt(sg);
+    auto table = rt.get_table("table");
+    CHECK_EQUAL(table->size(), 40000);
+    auto col_int = table->get_column_key("int");
+    auto col_str = table->get_column_key("string");
+    int64_t sum = 0;
+    for (auto& obj : *table) {
+        sum += obj.get<Int>(col_int);
+        CHECK_EQUAL(obj.get<String>(col_str), payload);
+    }
+    CHECK_EQUAL(sum, 2 * int64_t(19999) * 20000 / 2);
+}
+
+TEST(Shared_ReclaimSpaceOfUnboundVersions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options;
+    options.reclaim_unbound_versions = true;
+    DBRef sg = DB::create(path, false, options);
+    ColKey col;
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 1000; ++i)
+            table->create_object().set(col, i);
+        wt.commit();
+    }
+    auto modify = [&](int num_commits) {
+        for (int n = 0; n < num_commits; ++n) {
+            WriteTransaction wt(sg);
+            for (auto& obj : *wt.get_table("table"))
+                obj.add_int(col, 1);
+            wt.commit();
+        }
+    };
+    auto get_locked_space = [&] {
+        size_t free_space, used_space, locked_space;
+        sg->get_stats(free_space, used_space, locked_space);
+        return locked_space;
+    };
+    auto check_values = [&](const TransactionRef& tr, int64_t offset) {
+        int64_t expected = offset;
+        for (auto& obj : *tr->get_table("table"))
+            CHECK_EQUAL(obj.get<Int>(col), expected++);
+    };
+
+    // A long running reader, and one bound to an intermediate version
+    auto long_reader = sg->start_read();
+    modify(10);
+    auto intermediate = sg->start_read();
+    modify(1);
+    VersionID unbound = sg->start_read()->get_version_of_current_transaction();
+    modify(9);
+    size_t locked_space = get_locked_space();
+
+    // Without reuse, the locked space would grow with every commit
+    modify(200);
+    CHECK_LESS(get_locked_space(), 2 * locked_space);
+    check_values(long_reader, 0);
+    check_values(intermediate, 10);
+
+    // Versions which nobody was reading can no longer be bound
+    CHECK_THROW(sg->start_read(unbound), DB::BadVersion);
+
+    long_reader->end_read();
+    intermediate->end_read();
+    modify(1);
+    check_values(sg->start_read(), 221);
+}
+
+TEST(Shared_BoundVersionsAndRetentionPolicy)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path);
+    ColKey col;
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 100; ++i)
+            table->create_object().set(col, i);
+        wt.commit();
+    }
+    auto modify = [&](int num_commits) {
+        for (int n = 0; n < num_commits; ++n) {
+            WriteTransaction wt(sg);
+            for (auto& obj : *wt.get_table("table"))
+                obj.add_int(col, 1);
+            wt.commit();
+        }
+    };
+
+    // Transactions of the same DB on the same version share a binding
+    auto reader = sg->start_read();
+    auto reader_2 = sg->start_read();
+    modify(5);
+    auto bound = sg->get_bound_versions();
+    CHECK_EQUAL(bound.size(), 1);
+    CHECK_EQUAL(bound[0].version, reader->get_version_of_current_transaction().version);
+    CHECK_EQUAL(bound[0].num_bindings, 1);
+    CHECK_NOT_EQUAL(bound[0].process_id, 0);
+    CHECK_GREATER(bound[0].locked_space, 0);
+    CHECK(bound[0].age.count() >= 0);
+
+    int num_calls = 0;
+    std::vector<DB::BoundVersionInfo> reported;
+    DB::RetentionPolicy policy;
+    policy.max_bound_versions = 1;
+    policy.on_exceeded = [&](const std::vector<DB::BoundVersionInfo>& versions) {
+        ++num_calls;
+        reported = versions;
+        // The write lock has been released
+        sg->start_write()->rollback();
+    };
+    sg->set_retention_policy(policy);
+    modify(1);
+    CHECK_EQUAL(num_calls, 0);
+
+    // A second old version exceeds the limit
+    auto reader_3 = sg->start_read();
+    modify(2);
+    CHECK_EQUAL(num_calls, 1);
+    CHECK_EQUAL(reported.size(), 2);
+    CHECK_EQUAL(reported[1].version, reader_3->get_version_of_current_transaction().version);
+
+    reader->end_read();
+    reader_2->end_read();
+    reader_3->end_read();
+    modify(1);
+    CHECK_EQUAL(num_calls, 1);
+    CHECK_EQUAL(sg->get_bound_versions().size(), 0);
+
+    policy.max_bound_versions = 0;
+    policy.max_locked_space = 1;
+    sg->set_retention_policy(policy);
+    auto reader_4 = sg->start_read();
+    modify(2);
+    CHECK_GREATER(num_calls, 1);
+
+    num_calls = 0;
+    modify(1);
+    CHECK_EQUAL(num_calls, 1);
+
+    // An exception thrown by the callback does not escape the commit, which
+    // has already completed
+    policy.on_exceeded = [&](const std::vector<DB::BoundVersionInfo>&) {
+        ++num_calls;
+        throw std::runtime_error("callback failed");
+    };
+    sg->set_retention_policy(policy);
+    modify(1);
+    CHECK_EQUAL(num_calls, 2);
+    auto wt = sg->start_write();
+    wt->get_table("table")->create_object();
+    wt->commit_and_continue_as_read();
+    CHECK_EQUAL(num_calls, 3);
+}
+
+
+TEST(Shared_LockedSpaceOfBoundVersions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path);
+    ColKey col;
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 10000; ++i)
+            table->create_object().set(col, int64_t(1) << 40);
+        wt.commit();
+    }
+    auto modify = [&](bool all) {
+        WriteTransaction wt(sg);
+        auto table = wt.get_table("table");
+        if (all) {
+            for (auto& obj : *table)
+                obj.add_int(col, 1);
+        }
+        else {
+            table->begin()->add_int(col, 1);
+        }
+        wt.commit();
+    };
+
+    // Releases the space of all 10000 values
+    modify(true);
+    auto reader_1 = sg->start_read();
+    modify(false);
+    auto reader_2 = sg->start_read();
+    modify(false);
+    // The space released by the commit which created the version of reader_1
+    // is not used by reader_1, so only what the next commit released is
+    // attributed to it
+    auto bound = sg->get_bound_versions();
+    CHECK_EQUAL(bound.size(), 2);
+    CHECK_EQUAL(bound[0].version, reader_1->get_version_of_current_transaction().version);
+    CHECK_GREATER(bound[0].locked_space, 0);
+    CHECK_LESS(bound[0].locked_space, 10000 * 8 / 2);
+}
+
 TEST(Shared_VersionOfBoundSnapshot)
 {
     SHARED_GROUP_TEST_PATH(path);
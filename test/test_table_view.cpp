@@ -2931,4 +2931,57 @@ TEST(TableView_TimestampMaxRemoveRow)
     CHECK_EQUAL(tv.maximum_timestamp(col_date), Timestamp(8, 0));
 }
 
+TEST(TableView_ClearInBulk)
+{
+    Group g;
+    auto origins = g.add_table("origins");
+    auto targets = g.add_table("targets");
+    auto col_value = targets->add_column(type_Int, "value");
+    auto col_name = targets->add_column(type_String, "name");
+    auto col_next = targets->add_column_link(type_Link, "next", *targets);
+    auto col_link = origins->add_column_link(type_Link, "link", *targets);
+    auto col_list = origins->add_column_link(type_LinkList, "list", *targets);
+    targets->add_search_index(col_name);
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 3000; ++i)
+        keys.push_back(targets->create_object().set(col_value, i % 10).set(col_name, util::to_string(i)).get_key());
+    for (int i = 0; i < 3000; ++i) {
+        targets->get_object(keys[i]).set(col_next, keys[(i + 7) % keys.size()]);
+        auto origin = origins->create_object().set(col_link, keys[(i * 3) % keys.size()]);
+        auto list = origin.get_linklist(col_list);
+        for (int j = 0; j < 3; ++j)
+            list.add(keys[(i + j * 11) % keys.size()]);
+    }
+
+    TableView view = targets->where().less(col_value, 7).find_all();
+    CHECK_EQUAL(view.size(), 2100);
+    view.clear();
+    CHECK_EQUAL(view.size(), 0);
+    CHECK_EQUAL(targets->size(), 900);
+    for (auto obj : *targets) {
+        CHECK_GREATER_EQUAL(obj.get<Int>(col_value), 7);
+        ObjKey next = obj.get<ObjKey>(col_next);
+        CHECK(!next || targets->get_object(next).get<Int>(col_value) >= 7);
+        CHECK_EQUAL(targets->find_first_string(col_name, obj.get<String>(col_name)), obj.get_key());
+    }
+    CHECK_EQUAL(targets->find_first_string(col_name, "0"), null_key);
+    size_t links = 0;
+    for (auto obj : *origins) {
+        ObjKey target = obj.get<ObjKey>(col_link);
+        CHECK(!target || targets->is_valid(target));
+        links += bool(target);
+        auto list = obj.get_linklist(col_list);
+        for (size_t i = 0; i < list.size(); ++i)
+            CHECK(targets->is_valid(list.get(i)));
+    }
+    CHECK_EQUAL(links, 900);
+    g.verify();
+
+    // Removing the rest through a query
+    CHECK_EQUAL(targets->where().remove(), 900);
+    CHECK_EQUAL(targets->size(), 0);
+    g.verify();
+}
+
 #endif // TEST_TABLE_VIEW
@@ -275,6 +275,64 @@ TEST(Transactions_StateChanges)
     CHECK_THROW(tr->create_object(), realm::LogicError);
 }
 
+TEST(Transactions_PooledFrozen)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    DBRef db = DB::create(*hist_w, DBOptions(crypt_key()));
+    {
+        auto wt = db->start_write();
+        wt->add_table("table")->add_column(type_Int, "int");
+        wt->commit();
+    }
+    TransactionRef reader = db->start_read();
+    TransactionRef frozen_1 = reader->freeze();
+    TransactionRef frozen_2 = db->start_frozen(reader->get_version_of_current_transaction());
+    TransactionRef duplicate = frozen_1->duplicate();
+    // Every holder gets a transaction of its own
+    CHECK_NOT_EQUAL(frozen_1, frozen_2);
+    CHECK_NOT_EQUAL(frozen_1, duplicate);
+    CHECK(duplicate->is_frozen());
+
+    // Closing one of them ends that one only, and releases its read lock
+    frozen_1->close();
+    CHECK_NOT(frozen_1->is_frozen());
+    CHECK(frozen_2->is_frozen());
+    CHECK_EQUAL(frozen_2->get_table("table")->size(), 0);
+    duplicate->end_read();
+    CHECK_NOT(duplicate->is_frozen());
+    CHECK(frozen_2->is_frozen());
+
+    {
+        auto wt = db->start_write();
+        wt->get_table("table")->create_object();
+        wt->commit();
+    }
+
+    // A released frozen transaction is reused, together with its accessors,
+    // when freezing again, also at a newer version
+    Transaction* released = frozen_2.get();
+    ConstTableRef table = frozen_2->get_table("table");
+    const Table* table_accessor = table.unchecked_ptr();
+    frozen_2 = nullptr;
+    CHECK_NOT(table);
+    TransactionRef frozen_3 = db->start_frozen();
+    CHECK_EQUAL(frozen_3.get(), released);
+    CHECK(frozen_3->is_frozen());
+    table = frozen_3->get_table("table");
+    CHECK_EQUAL(table.unchecked_ptr(), table_accessor);
+    CHECK(table->is_frozen());
+    CHECK_EQUAL(table->size(), 1);
+
+    // Pooled read transactions are not handed out as frozen ones
+    TransactionRef pooled_reader = db->start_read_pooled();
+    Transaction* released_reader = pooled_reader.get();
+    pooled_reader = nullptr;
+    TransactionRef frozen_4 = db->start_frozen();
+    CHECK_NOT_EQUAL(frozen_4.get(), released_reader);
+    CHECK(frozen_4->get_table("table")->is_frozen());
+}
+
 namespace {
 
 void writer_thread(TestContext& test_context, int runs, DBRef db, TableKey tk)